@@ -47,10 +47,33 @@ static const char *const atomNameArray[] = {
     NULL
 };
 
+#if !defined(_WIN32) && !defined(MAC_OSX_TK)
+/*
+ * Atoms that Tk needs on almost every X11 display, for the selection and for
+ * managing toplevel windows. AtomInit interns all of them with a single
+ * XInternAtoms request, so that creating the first toplevel over a slow
+ * connection does not wait for one server round-trip per atom.
+ */
+
+static const char *const prefetchAtomNames[] = {
+    "ATOM_PAIR",		"CLIPBOARD",		"COMPOUND_TEXT",
+    "INCR",			"MULTIPLE",		"TARGETS",
+    "TEXT",			"TIMESTAMP",		"TK_APPLICATION",
+    "TK_WINDOW",		"UTF8_STRING",		"WM_DELETE_WINDOW",
+    "WM_PROTOCOLS",		"_NET_WM_ICON_NAME",	"_NET_WM_NAME",
+    "_NET_WM_PID",		"_NET_WM_PING",		"_NET_WM_STATE",
+    "_NET_WM_STATE_ABOVE",	"_NET_WM_STATE_FULLSCREEN",
+    "_NET_WM_STATE_MAXIMIZED_HORZ", "_NET_WM_STATE_MAXIMIZED_VERT",
+    "_NET_WM_WINDOW_TYPE",	"_NET_WM_WINDOW_TYPE_NORMAL",
+    NULL
+};
+#endif
+
 /*
  * Forward references to functions defined in this file:
  */
 
+static void	AddAtom(TkDisplay *dispPtr, const char *name, Atom atom);
 static void	AtomInit(TkDisplay *dispPtr);
 
 /*
@@ -80,22 +103,18 @@ Tk_InternAtom(
 {
     TkDisplay *dispPtr;
     Tcl_HashEntry *hPtr;
-    int isNew;
 
     dispPtr = ((TkWindow *) tkwin)->dispPtr;
     if (!dispPtr->atomInit) {
 	AtomInit(dispPtr);
     }
 
-    hPtr = Tcl_CreateHashEntry(&dispPtr->nameTable, name, &isNew);
-    if (isNew) {
-	Tcl_HashEntry *hPtr2;
-	Atom atom;
+    hPtr = Tcl_FindHashEntry(&dispPtr->nameTable, name);
+    if (hPtr == NULL) {
+	Atom atom = XInternAtom(dispPtr->display, name, False);
 
-	atom = XInternAtom(dispPtr->display, name, False);
-	Tcl_SetHashValue(hPtr, INT2PTR(atom));
-	hPtr2 = Tcl_CreateHashEntry(&dispPtr->atomTable, INT2PTR(atom), &isNew);
-	Tcl_SetHashValue(hPtr2, Tcl_GetHashKey(&dispPtr->nameTable, hPtr));
+	AddAtom(dispPtr, name, atom);
+	return atom;
     }
     return (Atom)PTR2INT(Tcl_GetHashValue(hPtr));
 }
@@ -204,6 +223,56 @@ AtomInit(
 	hPtr = Tcl_CreateHashEntry(&dispPtr->atomTable, INT2PTR(atom), &isNew);
 	Tcl_SetHashValue(hPtr, (char *)name);
     }
+
+#if !defined(_WIN32) && !defined(MAC_OSX_TK)
+    {
+	Atom atoms[sizeof(prefetchAtomNames) / sizeof(prefetchAtomNames[0])];
+	int i, count = (int) (sizeof(atoms) / sizeof(atoms[0])) - 1;
+
+	if (XInternAtoms(dispPtr->display, (char **) prefetchAtomNames, count,
+		False, atoms)) {
+	    for (i = 0; i < count; i++) {
+		if ((atoms[i] != None) && (Tcl_FindHashEntry(&dispPtr->nameTable,
+			prefetchAtomNames[i]) == NULL)) {
+		    AddAtom(dispPtr, prefetchAtomNames[i], atoms[i]);
+		}
+	    }
+	}
+    }
+#endif
+}
+
+/*
+ *--------------------------------------------------------------
+ *
+ * AddAtom --
+ *
+ *	Record the mapping between an atom and its name in the atom cache of
+ *	a display.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Entries are added to the name and atom tables of the display.
+ *
+ *--------------------------------------------------------------
+ */
+
+static void
+AddAtom(
+    TkDisplay *dispPtr,		/* Display whose cache is updated. */
+    const char *name,		/* Name of the atom. */
+    Atom atom)			/* The atom itself. */
+{
+    Tcl_HashEntry *hPtr;
+    int isNew;
+
+    hPtr = Tcl_CreateHashEntry(&dispPtr->nameTable, name, &isNew);
+    Tcl_SetHashValue(hPtr, INT2PTR(atom));
+    name = (const char *)Tcl_GetHashKey(&dispPtr->nameTable, hPtr);
+    hPtr = Tcl_CreateHashEntry(&dispPtr->atomTable, INT2PTR(atom), &isNew);
+    Tcl_SetHashValue(hPtr, (char *)name);
 }
 
 /*
@@ -242,6 +242,29 @@ typedef struct {
 
 TK_PTR_ARRAY_DEFINE(VirtOwners, Tcl_HashEntry); /* define array of hash entries */
 
+/*
+ * The following structure holds the compiled form of a binding script. It is
+ * built the first time the binding fires, and thrown away whenever the script
+ * changes. A script without any %-sequences is kept as a Tcl_Obj, so that its
+ * bytecode survives from one event to the next. A script consisting of a
+ * single command whose %-sequences all form complete words is kept as an
+ * array of words; it is evaluated as a pure list, so that neither the
+ * literal words nor the command itself have to be parsed again. All other
+ * scripts are expanded with ExpandPercents on every event.
+ */
+
+typedef struct {
+    char percent;		/* Character following the '%', or '\0' if this is a literal word. */
+    Tcl_Obj *literalObj;	/* The literal word, or NULL for a %-sequence. */
+} BindWord;
+
+typedef struct {
+    Tcl_Obj *scriptObj;		/* Script without %-sequences, or NULL. */
+    Tcl_Size numWords;		/* Number of words in "words", zero if the script must be
+				 * expanded. */
+    BindWord words[TKFLEXARRAY];/* Words of the command. */
+} BindCmd;
+
 /*
  * The following structure defines a pattern sequence, which consists of one
  * or more patterns. In order to trigger, a pattern sequence must match the
@@ -270,6 +293,8 @@ typedef struct PatSeq {
     unsigned modMaskUsed:1;	/* Does at least one pattern contain a non-zero modifier mask? */
     DEBUG(unsigned owned:1;)	/* For debugging purposes. */
     char *script;		/* Binding script to evaluate when sequence matches (ckalloc()ed) */
+    BindCmd *cmdPtr;		/* Compiled form of script, NULL until the binding fires for the
+				 * first time. */
     Tcl_Obj* object;		/* Token for object with which binding is associated. For virtual
 				 * event table this is NULL. */
     struct PatSeq *nextSeqPtr;	/* Next in list of all pattern sequences that have the same initial
@@ -695,6 +720,12 @@ static int		CreateVirtualEvent(Tcl_Interp *interp, VirtualEventTable *vetPtr,
 static int		DeleteVirtualEvent(Tcl_Interp *interp, VirtualEventTable *vetPtr,
 			    char *virtString, const char *eventString);
 static void		DeleteVirtualEventTable(VirtualEventTable *vetPtr);
+static BindCmd *	CompileBindScript(const char *script);
+static void		FreeBindCmd(BindCmd *cmdPtr);
+static Tcl_Obj *	GetBindCmdObj(TkWindow *winPtr, PatSeq *psPtr, Event *eventPtr,
+			    unsigned scriptCount);
+static const char *	GetPercentValue(TkWindow *winPtr, Event *eventPtr, char percent,
+			    unsigned scriptCount, char *numStorage, Tcl_DString *bufPtr);
 static void		ExpandPercents(TkWindow *winPtr, const char *before, Event *eventPtr,
 			    unsigned scriptCount, Tcl_DString *dsPtr);
 static PatSeq *		FindSequence(Tcl_Interp *interp, LookupTables *lookupTables,
@@ -889,6 +920,7 @@ FreePatSeq(
     assert(!psPtr->owned);
     DEBUG(MARK_PSENTRY(psPtr);)
     ckfree(psPtr->script);
+    FreeBindCmd(psPtr->cmdPtr);
     if (!psPtr->object) {
 	VirtOwners_Free(&psPtr->ptr.owners);
     }
@@ -1691,6 +1723,8 @@ Tk_CreateBinding(
     }
     ckfree(oldStr);
     psPtr->script = newStr;
+    FreeBindCmd(psPtr->cmdPtr);
+    psPtr->cmdPtr = NULL;
     return eventMask;
 }
 
@@ -2157,9 +2191,10 @@ Tk_BindEvent(
     PatSeq *matchPtrBuf[32];
     PatSeq **matchPtrArr = matchPtrBuf;
     PSList *psl[2];
-    Tcl_DString scripts;
-    const char *p;
-    const char *end;
+    Tcl_Obj *cmdObjBuf[32];
+    Tcl_Obj **cmdObjArr = cmdObjBuf;
+    Tcl_WideInt statsStart;
+    Tk_Uid statsClass;
     unsigned scriptCount;
     int oldScreen;
     unsigned flags;
@@ -2340,11 +2375,11 @@ Tk_BindEvent(
     physTables = &bindPtr->lookupTables;
     scriptCount = 0;
     arraySize = 0;
-    Tcl_DStringInit(&scripts);
 
     if ((size_t) numObjects > SIZE_OF_ARRAY(matchPtrBuf)) {
 	/* It's unrealistic that the buffer size is too small, but who knows? */
 	matchPtrArr = (PatSeq **)ckalloc(numObjects*sizeof(matchPtrArr[0]));
+	cmdObjArr = (Tcl_Obj **)ckalloc(numObjects*sizeof(cmdObjArr[0]));
     }
     memset(matchPtrArr, 0, numObjects*sizeof(matchPtrArr[0]));
 
@@ -2446,9 +2481,8 @@ Tk_BindEvent(
 	}
 
 	if (matchPtrArr[k]) {
-	    ExpandPercents(winPtr, matchPtrArr[k]->script, curEvent, scriptCount++, &scripts);
-	    /* Null is added to the scripts string to separate the various scripts. */
-	    Tcl_DStringAppend(&scripts, "", 1);
+	    cmdObjArr[scriptCount] = GetBindCmdObj(winPtr, matchPtrArr[k], curEvent, scriptCount);
+	    ++scriptCount;
 	}
     }
 
@@ -2523,7 +2557,10 @@ Tk_BindEvent(
 	ckfree(matchPtrArr);
     }
 
-    if (Tcl_DStringLength(&scripts) == 0) {
+    if (scriptCount == 0) {
+	if (cmdObjArr != cmdObjBuf) {
+	    ckfree(cmdObjArr);
+	}
 	return; /* Nothing to do. */
     }
 
@@ -2569,9 +2606,10 @@ Tk_BindEvent(
      */
 
     Tcl_Preserve(bindInfoPtr);
+    statsStart = TkStatsStart();
+    statsClass = Tk_Class(tkwin);
 
-    for (p = Tcl_DStringValue(&scripts), end = p + Tcl_DStringLength(&scripts); p < end; ) {
-	Tcl_Size len = strlen(p);
+    for (i = 0; i < (Tcl_Size) scriptCount; ++i) {
 	int code;
 
 	if (!bindInfoPtr->deleted) {
@@ -2579,8 +2617,7 @@ Tk_BindEvent(
 	}
 	Tcl_AllowExceptions(interp);
 
-	code = Tcl_EvalEx(interp, p, len, TCL_EVAL_GLOBAL);
-	p += len + 1;
+	code = Tcl_EvalObjEx(interp, cmdObjArr[i], TCL_EVAL_GLOBAL);
 
 	if (!bindInfoPtr->deleted) {
 	    --screenPtr->bindingDepth;
@@ -2593,6 +2630,9 @@ Tk_BindEvent(
 	    break;
 	}
     }
+    if (statsStart != 0) {
+	TkStatsRecord(TK_STATS_BIND, statsClass, statsStart);
+    }
 
     if (!bindInfoPtr->deleted
 	    && screenPtr->bindingDepth > 0
@@ -2606,7 +2646,12 @@ Tk_BindEvent(
 	ChangeScreen(interp, oldDispPtr->name, oldScreen);
     }
     Tcl_RestoreInterpState(interp, interpState);
-    Tcl_DStringFree(&scripts);
+    for (i = 0; i < (Tcl_Size) scriptCount; ++i) {
+	Tcl_DecrRefCount(cmdObjArr[i]);
+    }
+    if (cmdObjArr != cmdObjBuf) {
+	ckfree(cmdObjArr);
+    }
     Tcl_Release(bindInfoPtr);
 }
 
@@ -2936,6 +2981,300 @@ MatchPatterns(
     return bestPtr;
 }
 
+/*
+ *--------------------------------------------------------------
+ *
+ * GetPercentValue --
+ *
+ *	Compute the replacement for a single % construct from the information
+ *	in the X event.
+ *
+ * Results:
+ *	The return value is the replacement string. It points either to a
+ *	static string, to numStorage, or to the contents of bufPtr, so it is
+ *	only valid until the next call.
+ *
+ * Side effects:
+ *	None.
+ *
+ *--------------------------------------------------------------
+ */
+
+static const char *
+GetPercentValue(
+    TkWindow *winPtr,		/* Window where event occurred: needed to get input context. */
+    Event *eventPtr,		/* Event containing information to be used in % replacements. */
+    char percent,		/* Character following the '%'. */
+    unsigned scriptCount,	/* The number of script-based binding patterns matched so far for
+				 * this event. */
+    char *numStorage,		/* Space for formatting numbers, at least TCL_INTEGER_SPACE
+				 * bytes. */
+    Tcl_DString *bufPtr)	/* Initialized dynamic string used for %A. */
+{
+    unsigned flags;
+    XEvent *evPtr;
+    const char *string;
+    long long number;     /* signed */
+    unsigned long long unumber;   /* unsigned */
+
+    evPtr = &eventPtr->xev;
+    flags = (evPtr->type < TK_LASTEVENT) ? flagArray[evPtr->type] : 0;
+
+#define SET_NUMBER(value)   { number = (value);			     \
+    snprintf(numStorage, TCL_INTEGER_SPACE, "%" TCL_LL_MODIFIER "d", number);	     \
+    string = numStorage;					     \
+    }
+
+#define SET_UNUMBER(value)  { unumber = (value);				\
+	snprintf(numStorage, TCL_INTEGER_SPACE, "%" TCL_LL_MODIFIER "u", unumber);	\
+	string = numStorage;						\
+    }
+
+    string = "??";
+    switch (percent) {
+    case '#':
+	SET_UNUMBER(evPtr->xany.serial);
+	break;
+    case 'a':
+	if (flags & CONFIG) {
+	    TkpPrintWindowId(numStorage, evPtr->xconfigure.above);
+	    string = numStorage;
+	}
+	break;
+    case 'b':
+	if (flags & BUTTON) {
+	    SET_UNUMBER(evPtr->xbutton.button);
+	}
+	break;
+    case 'c':
+	if (flags & EXPOSE) {
+	    SET_NUMBER(evPtr->xexpose.count);
+	}
+	break;
+    case 'd':
+	if (flags & (CROSSING|FOCUS)) {
+	    int detail = (flags & FOCUS) ? evPtr->xfocus.detail : evPtr->xcrossing.detail;
+	    string = TkFindStateString(notifyDetail, detail);
+	} else if (flags & CONFIGREQ) {
+	    if (evPtr->xconfigurerequest.value_mask & CWStackMode) {
+		string = TkFindStateString(configureRequestDetail, evPtr->xconfigurerequest.detail);
+	    } else {
+		string = "";
+	    }
+	} else if (flags & VIRTUAL) {
+	    XVirtualEvent *vePtr = (XVirtualEvent *) evPtr;
+	    string = vePtr->user_data ? Tcl_GetString(vePtr->user_data) : "";
+	}
+	break;
+    case 'f':
+	if (flags & CROSSING) {
+	    SET_NUMBER(evPtr->xcrossing.focus != 0);
+	}
+	break;
+    case 'h':
+	if (flags & EXPOSE) {
+	    SET_NUMBER(evPtr->xexpose.height);
+	} else if (flags & CONFIG) {
+	    SET_NUMBER(evPtr->xconfigure.height);
+	} else if (flags & CREATE) {
+	    SET_NUMBER(evPtr->xcreatewindow.height);
+	} else if (flags & CONFIGREQ) {
+	    SET_NUMBER(evPtr->xconfigurerequest.height);
+	} else if (flags & RESIZEREQ) {
+	    SET_NUMBER(evPtr->xresizerequest.height);
+	}
+	break;
+    case 'i':
+	if (flags & CREATE) {
+	    TkpPrintWindowId(numStorage, evPtr->xcreatewindow.window);
+	} else if (flags & CONFIGREQ) {
+	    TkpPrintWindowId(numStorage, evPtr->xconfigurerequest.window);
+	} else if (flags & MAPREQ) {
+	    TkpPrintWindowId(numStorage, evPtr->xmaprequest.window);
+	} else {
+	    TkpPrintWindowId(numStorage, evPtr->xany.window);
+	}
+	string = numStorage;
+	break;
+    case 'k':
+	if (flags & KEY) {
+	    SET_UNUMBER(evPtr->xkey.keycode);
+	}
+	break;
+    case 'm':
+	if (flags & CROSSING) {
+	    string = TkFindStateString(notifyMode, evPtr->xcrossing.mode);
+	} else if (flags & FOCUS) {
+	    string = TkFindStateString(notifyMode, evPtr->xfocus.mode);
+	}
+	break;
+    case 'o':
+	if (flags & CREATE) {
+	    SET_NUMBER(evPtr->xcreatewindow.override_redirect != 0);
+	} else if (flags & MAP) {
+	    SET_NUMBER(evPtr->xmap.override_redirect != 0);
+	} else if (flags & REPARENT) {
+	    SET_NUMBER(evPtr->xreparent.override_redirect != 0);
+	} else if (flags & CONFIG) {
+	    SET_NUMBER(evPtr->xconfigure.override_redirect != 0);
+	}
+	break;
+    case 'p':
+	if (flags & CIRC) {
+	    string = TkFindStateString(circPlace, evPtr->xcirculate.place);
+	} else if (flags & CIRCREQ) {
+	    string = TkFindStateString(circPlace, evPtr->xcirculaterequest.place);
+	}
+	break;
+    case 's':
+	if (flags & HAS_XKEY_HEAD_AND_STATE) {
+	    SET_UNUMBER(evPtr->xkey.state);
+	} else if (flags & CROSSING) {
+	    SET_UNUMBER(evPtr->xcrossing.state);
+	} else if (flags & PROP) {
+	    string = TkFindStateString(propNotify, evPtr->xproperty.state);
+	} else if (flags & VISIBILITY) {
+	    string = TkFindStateString(visNotify, evPtr->xvisibility.state);
+	}
+	break;
+    case 't':
+	if (flags & HAS_XKEY_HEAD) {
+	    SET_UNUMBER(evPtr->xkey.time);
+	} else if (flags & PROP) {
+	    SET_UNUMBER(evPtr->xproperty.time);
+	}
+	break;
+    case 'v':
+	SET_UNUMBER(evPtr->xconfigurerequest.value_mask);
+	break;
+    case 'w':
+	if (flags & EXPOSE) {
+	    SET_NUMBER(evPtr->xexpose.width);
+	} else if (flags & CONFIG) {
+	    SET_NUMBER(evPtr->xconfigure.width);
+	} else if (flags & CREATE) {
+	    SET_NUMBER(evPtr->xcreatewindow.width);
+	} else if (flags & CONFIGREQ) {
+	    SET_NUMBER(evPtr->xconfigurerequest.width);
+	} else if (flags & RESIZEREQ) {
+	    SET_NUMBER(evPtr->xresizerequest.width);
+	}
+	break;
+    case 'x':
+	if (flags & HAS_XKEY_HEAD) {
+	    SET_NUMBER(evPtr->xkey.x);
+	} else if (flags & EXPOSE) {
+	    SET_NUMBER(evPtr->xexpose.x);
+	} else if (flags & (CREATE|CONFIG|GRAVITY)) {
+	    SET_NUMBER(evPtr->xcreatewindow.x);
+	} else if (flags & REPARENT) {
+	    SET_NUMBER(evPtr->xreparent.x);
+	} else if (flags & CONFIGREQ) {
+	    SET_NUMBER(evPtr->xconfigurerequest.x);
+	}
+	break;
+    case 'y':
+	if (flags & HAS_XKEY_HEAD) {
+	    SET_NUMBER(evPtr->xkey.y);
+	} else if (flags & EXPOSE) {
+	    SET_NUMBER(evPtr->xexpose.y);
+	} else if (flags & (CREATE|CONFIG|GRAVITY)) {
+	    SET_NUMBER(evPtr->xcreatewindow.y);
+	} else if (flags & REPARENT) {
+	    SET_NUMBER(evPtr->xreparent.y);
+	} else if (flags & CONFIGREQ) {
+	    SET_NUMBER(evPtr->xconfigurerequest.y);
+	}
+	break;
+    case 'A':
+	if (flags & KEY) {
+	    Tcl_DStringFree(bufPtr);
+	    string = TkpGetString(winPtr, evPtr, bufPtr);
+	}
+	break;
+    case 'B':
+	if (flags & CREATE) {
+	    SET_NUMBER(evPtr->xcreatewindow.border_width);
+	} else if (flags & CONFIGREQ) {
+	    SET_NUMBER(evPtr->xconfigurerequest.border_width);
+	} else if (flags & CONFIG) {
+	    SET_NUMBER(evPtr->xconfigure.border_width);
+	}
+	break;
+    case 'D':
+	if (flags & WHEEL) {
+	    SET_NUMBER((int)evPtr->xbutton.button); /* mis-use button field for this */
+	}
+	break;
+    case 'E':
+	SET_NUMBER(evPtr->xany.send_event != 0);
+	break;
+    case 'K':
+	if (flags & KEY) {
+	    const char *name = TkKeysymToString(eventPtr->detail.info);
+	    if (name) {
+		string = name;
+	    }
+	}
+	break;
+    case 'M':
+	SET_UNUMBER(scriptCount);
+	break;
+    case 'N':
+	if (flags & KEY) {
+	    SET_UNUMBER(eventPtr->detail.info);
+	}
+	break;
+    case 'P':
+	if (flags & PROP) {
+	    string = Tk_GetAtomName((Tk_Window) winPtr, evPtr->xproperty.atom);
+	}
+	break;
+    case 'R':
+	if (flags & HAS_XKEY_HEAD) {
+	    TkpPrintWindowId(numStorage, evPtr->xkey.root);
+	    string = numStorage;
+	}
+	break;
+    case 'S':
+	if (flags & HAS_XKEY_HEAD) {
+	    TkpPrintWindowId(numStorage, evPtr->xkey.subwindow);
+	    string = numStorage;
+	}
+	break;
+    case 'T':
+	SET_NUMBER(evPtr->type);
+	break;
+    case 'W': {
+	Tk_Window tkwin = Tk_IdToWindow(evPtr->xany.display, evPtr->xany.window);
+	if (tkwin) {
+	    string = Tk_PathName(tkwin);
+	}
+	break;
+    }
+    case 'X':
+	if (flags & HAS_XKEY_HEAD) {
+	    SET_NUMBER(evPtr->xkey.x_root);
+	}
+	break;
+    case 'Y':
+	if (flags & HAS_XKEY_HEAD) {
+	    SET_NUMBER(evPtr->xkey.y_root);
+	}
+	break;
+    default:
+	numStorage[0] = percent;
+	numStorage[1] = '\0';
+	string = numStorage;
+	break;
+    }
+
+#undef SET_NUMBER
+#undef SET_UNUMBER
+
+    return string;
+}
+
 /*
  *--------------------------------------------------------------
  *
@@ -2963,9 +3302,7 @@ ExpandPercents(
 				 * this event. */
     Tcl_DString *dsPtr)		/* Dynamic string in which to append new command. */
 {
-    unsigned flags;
     Tcl_DString buf;
-    XEvent *evPtr;
 
     assert(winPtr);
     assert(before);
@@ -2973,24 +3310,10 @@ ExpandPercents(
     assert(dsPtr);
 
     Tcl_DStringInit(&buf);
-    evPtr = &eventPtr->xev;
-    flags = (evPtr->type < TK_LASTEVENT) ? flagArray[evPtr->type] : 0;
-
-#define SET_NUMBER(value)   { number = (value);			     \
-    snprintf(numStorage, sizeof(numStorage), "%" TCL_LL_MODIFIER "d", number);	     \
-    string = numStorage;					     \
-    }
-
-#define SET_UNUMBER(value)  { unumber = (value);				\
-	snprintf(numStorage, sizeof(numStorage), "%" TCL_LL_MODIFIER "u", unumber);	\
-	string = numStorage;						\
-    }
 
     while (1) {
 	char numStorage[TCL_INTEGER_SPACE];
 	const char *string;
-	long long number;     /* signed */
-	unsigned long long unumber;   /* unsigned */
 
 	/*
 	 * Find everything up to the next % character and append it to the
@@ -3011,244 +3334,7 @@ ExpandPercents(
 	 * There's a percent sequence here. Process it.
 	 */
 
-	string = "??";
-	switch (before[1]) {
-	case '#':
-	    SET_UNUMBER(evPtr->xany.serial);
-	    break;
-	case 'a':
-	    if (flags & CONFIG) {
-		TkpPrintWindowId(numStorage, evPtr->xconfigure.above);
-		string = numStorage;
-	    }
-	    break;
-	case 'b':
-	    if (flags & BUTTON) {
-		SET_UNUMBER(evPtr->xbutton.button);
-	    }
-	    break;
-	case 'c':
-	    if (flags & EXPOSE) {
-		SET_NUMBER(evPtr->xexpose.count);
-	    }
-	    break;
-	case 'd':
-	    if (flags & (CROSSING|FOCUS)) {
-		int detail = (flags & FOCUS) ? evPtr->xfocus.detail : evPtr->xcrossing.detail;
-		string = TkFindStateString(notifyDetail, detail);
-	    } else if (flags & CONFIGREQ) {
-		if (evPtr->xconfigurerequest.value_mask & CWStackMode) {
-		    string = TkFindStateString(configureRequestDetail, evPtr->xconfigurerequest.detail);
-		} else {
-		    string = "";
-		}
-	    } else if (flags & VIRTUAL) {
-		XVirtualEvent *vePtr = (XVirtualEvent *) evPtr;
-		string = vePtr->user_data ? Tcl_GetString(vePtr->user_data) : "";
-	    }
-	    break;
-	case 'f':
-	    if (flags & CROSSING) {
-		SET_NUMBER(evPtr->xcrossing.focus != 0);
-	    }
-	    break;
-	case 'h':
-	    if (flags & EXPOSE) {
-		SET_NUMBER(evPtr->xexpose.height);
-	    } else if (flags & CONFIG) {
-		SET_NUMBER(evPtr->xconfigure.height);
-	    } else if (flags & CREATE) {
-		SET_NUMBER(evPtr->xcreatewindow.height);
-	    } else if (flags & CONFIGREQ) {
-		SET_NUMBER(evPtr->xconfigurerequest.height);
-	    } else if (flags & RESIZEREQ) {
-		SET_NUMBER(evPtr->xresizerequest.height);
-	    }
-	    break;
-	case 'i':
-	    if (flags & CREATE) {
-		TkpPrintWindowId(numStorage, evPtr->xcreatewindow.window);
-	    } else if (flags & CONFIGREQ) {
-		TkpPrintWindowId(numStorage, evPtr->xconfigurerequest.window);
-	    } else if (flags & MAPREQ) {
-		TkpPrintWindowId(numStorage, evPtr->xmaprequest.window);
-	    } else {
-		TkpPrintWindowId(numStorage, evPtr->xany.window);
-	    }
-	    string = numStorage;
-	    break;
-	case 'k':
-	    if (flags & KEY) {
-		SET_UNUMBER(evPtr->xkey.keycode);
-	    }
-	    break;
-	case 'm':
-	    if (flags & CROSSING) {
-		string = TkFindStateString(notifyMode, evPtr->xcrossing.mode);
-	    } else if (flags & FOCUS) {
-		string = TkFindStateString(notifyMode, evPtr->xfocus.mode);
-	    }
-	    break;
-	case 'o':
-	    if (flags & CREATE) {
-		SET_NUMBER(evPtr->xcreatewindow.override_redirect != 0);
-	    } else if (flags & MAP) {
-		SET_NUMBER(evPtr->xmap.override_redirect != 0);
-	    } else if (flags & REPARENT) {
-		SET_NUMBER(evPtr->xreparent.override_redirect != 0);
-	    } else if (flags & CONFIG) {
-		SET_NUMBER(evPtr->xconfigure.override_redirect != 0);
-	    }
-	    break;
-	case 'p':
-	    if (flags & CIRC) {
-		string = TkFindStateString(circPlace, evPtr->xcirculate.place);
-	    } else if (flags & CIRCREQ) {
-		string = TkFindStateString(circPlace, evPtr->xcirculaterequest.place);
-	    }
-	    break;
-	case 's':
-	    if (flags & HAS_XKEY_HEAD_AND_STATE) {
-		SET_UNUMBER(evPtr->xkey.state);
-	    } else if (flags & CROSSING) {
-		SET_UNUMBER(evPtr->xcrossing.state);
-	    } else if (flags & PROP) {
-		string = TkFindStateString(propNotify, evPtr->xproperty.state);
-	    } else if (flags & VISIBILITY) {
-		string = TkFindStateString(visNotify, evPtr->xvisibility.state);
-	    }
-	    break;
-	case 't':
-	    if (flags & HAS_XKEY_HEAD) {
-		SET_UNUMBER(evPtr->xkey.time);
-	    } else if (flags & PROP) {
-		SET_UNUMBER(evPtr->xproperty.time);
-	    }
-	    break;
-	case 'v':
-	    SET_UNUMBER(evPtr->xconfigurerequest.value_mask);
-	    break;
-	case 'w':
-	    if (flags & EXPOSE) {
-		SET_NUMBER(evPtr->xexpose.width);
-	    } else if (flags & CONFIG) {
-		SET_NUMBER(evPtr->xconfigure.width);
-	    } else if (flags & CREATE) {
-		SET_NUMBER(evPtr->xcreatewindow.width);
-	    } else if (flags & CONFIGREQ) {
-		SET_NUMBER(evPtr->xconfigurerequest.width);
-	    } else if (flags & RESIZEREQ) {
-		SET_NUMBER(evPtr->xresizerequest.width);
-	    }
-	    break;
-	case 'x':
-	    if (flags & HAS_XKEY_HEAD) {
-		SET_NUMBER(evPtr->xkey.x);
-	    } else if (flags & EXPOSE) {
-		SET_NUMBER(evPtr->xexpose.x);
-	    } else if (flags & (CREATE|CONFIG|GRAVITY)) {
-		SET_NUMBER(evPtr->xcreatewindow.x);
-	    } else if (flags & REPARENT) {
-		SET_NUMBER(evPtr->xreparent.x);
-	    } else if (flags & CONFIGREQ) {
-		SET_NUMBER(evPtr->xconfigurerequest.x);
-	    }
-	    break;
-	case 'y':
-	    if (flags & HAS_XKEY_HEAD) {
-		SET_NUMBER(evPtr->xkey.y);
-	    } else if (flags & EXPOSE) {
-		SET_NUMBER(evPtr->xexpose.y);
-	    } else if (flags & (CREATE|CONFIG|GRAVITY)) {
-		SET_NUMBER(evPtr->xcreatewindow.y);
-	    } else if (flags & REPARENT) {
-		SET_NUMBER(evPtr->xreparent.y);
-	    } else if (flags & CONFIGREQ) {
-		SET_NUMBER(evPtr->xconfigurerequest.y);
-	    }
-	    break;
-	case 'A':
-	    if (flags & KEY) {
-		Tcl_DStringFree(&buf);
-		string = TkpGetString(winPtr, evPtr, &buf);
-	    }
-	    break;
-	case 'B':
-	    if (flags & CREATE) {
-		SET_NUMBER(evPtr->xcreatewindow.border_width);
-	    } else if (flags & CONFIGREQ) {
-		SET_NUMBER(evPtr->xconfigurerequest.border_width);
-	    } else if (flags & CONFIG) {
-		SET_NUMBER(evPtr->xconfigure.border_width);
-	    }
-	    break;
-	case 'D':
-	    if (flags & WHEEL) {
-		SET_NUMBER((int)evPtr->xbutton.button); /* mis-use button field for this */
-	    }
-	    break;
-	case 'E':
-	    SET_NUMBER(evPtr->xany.send_event != 0);
-	    break;
-	case 'K':
-	    if (flags & KEY) {
-		const char *name = TkKeysymToString(eventPtr->detail.info);
-		if (name) {
-		    string = name;
-		}
-	    }
-	    break;
-	case 'M':
-	    SET_UNUMBER(scriptCount);
-	    break;
-	case 'N':
-	    if (flags & KEY) {
-		SET_UNUMBER(eventPtr->detail.info);
-	    }
-	    break;
-	case 'P':
-	    if (flags & PROP) {
-		string = Tk_GetAtomName((Tk_Window) winPtr, evPtr->xproperty.atom);
-	    }
-	    break;
-	case 'R':
-	    if (flags & HAS_XKEY_HEAD) {
-		TkpPrintWindowId(numStorage, evPtr->xkey.root);
-		string = numStorage;
-	    }
-	    break;
-	case 'S':
-	    if (flags & HAS_XKEY_HEAD) {
-		TkpPrintWindowId(numStorage, evPtr->xkey.subwindow);
-		string = numStorage;
-	    }
-	    break;
-	case 'T':
-	    SET_NUMBER(evPtr->type);
-	    break;
-	case 'W': {
-	    Tk_Window tkwin = Tk_IdToWindow(evPtr->xany.display, evPtr->xany.window);
-	    if (tkwin) {
-		string = Tk_PathName(tkwin);
-	    }
-	    break;
-	}
-	case 'X':
-	    if (flags & HAS_XKEY_HEAD) {
-		SET_NUMBER(evPtr->xkey.x_root);
-	    }
-	    break;
-	case 'Y':
-	    if (flags & HAS_XKEY_HEAD) {
-		SET_NUMBER(evPtr->xkey.y_root);
-	    }
-	    break;
-	default:
-	    numStorage[0] = before[1];
-	    numStorage[1] = '\0';
-	    string = numStorage;
-	    break;
-	}
+	string = GetPercentValue(winPtr, eventPtr, before[1], scriptCount, numStorage, &buf);
 	{   /* local scope */
 	    int cvtFlags;
 	    Tcl_Size spaceNeeded = Tcl_ScanElement(string, &cvtFlags);
@@ -3262,12 +3348,222 @@ ExpandPercents(
 	}
     }
 
-#undef SET_NUMBER
-#undef SET_UNUMBER
-
     Tcl_DStringFree(&buf);
 }
-
+
+/*
+ *--------------------------------------------------------------
+ *
+ * CompileBindScript --
+ *
+ *	Analyze a binding script once, so that later events can evaluate it
+ *	without scanning and reparsing it. See the comment on BindCmd for the
+ *	forms that are recognized.
+ *
+ * Results:
+ *	The return value is a newly allocated BindCmd, to be released with
+ *	FreeBindCmd.
+ *
+ * Side effects:
+ *	None.
+ *
+ *--------------------------------------------------------------
+ */
+
+static BindCmd *
+CompileBindScript(
+    const char *script)		/* Binding script. */
+{
+    BindCmd *cmdPtr;
+    const char *p;
+    Tcl_Size maxWords = 1;
+    Tcl_Size numWords = 0;
+
+    assert(script);
+
+    if (!strchr(script, '%')) {
+	cmdPtr = (BindCmd *)ckalloc(sizeof(BindCmd));
+	cmdPtr->scriptObj = Tcl_NewStringObj(script, TCL_INDEX_NONE);
+	Tcl_IncrRefCount(cmdPtr->scriptObj);
+	cmdPtr->numWords = 0;
+	return cmdPtr;
+    }
+
+    for (p = script; *p; ++p) {
+	if (*p == ' ' || *p == '\t') {
+	    ++maxWords;
+	}
+    }
+    cmdPtr = (BindCmd *)ckalloc(offsetof(BindCmd, words) + maxWords*sizeof(BindWord));
+    cmdPtr->scriptObj = NULL;
+
+    /*
+     * Split the script into words. We only accept words which need neither
+     * substitution nor quoting, and %-sequences which form a complete word,
+     * so that the result is the same as substituting the %-sequences first
+     * and then parsing the command.
+     */
+
+    p = script;
+    while (1) {
+	const char *start;
+
+	while (*p == ' ' || *p == '\t' || (numWords == 0 && *p == '\n')) {
+	    ++p;
+	}
+	if (*p == '\0' || *p == '\n' || *p == ';') {
+	    break;
+	}
+	for (start = p; *p && !strchr(" \t\n;", *p); ++p) {
+	    if (strchr("$[]{}\\\"#", *p) || UCHAR(*p) < ' ') {
+		goto expand;
+	    }
+	}
+	if (*start == '%') {
+	    if (p - start != 2) {
+		goto expand;
+	    }
+	    cmdPtr->words[numWords].percent = start[1];
+	    cmdPtr->words[numWords].literalObj = NULL;
+	} else {
+	    if (memchr(start, '%', p - start)) {
+		goto expand;
+	    }
+	    cmdPtr->words[numWords].percent = '\0';
+	    cmdPtr->words[numWords].literalObj = Tcl_NewStringObj(start, p - start);
+	    Tcl_IncrRefCount(cmdPtr->words[numWords].literalObj);
+	}
+	++numWords;
+    }
+
+    /*
+     * Only a single command is accepted, trailing white space and command
+     * separators are harmless.
+     */
+
+    for ( ; *p; ++p) {
+	if (!strchr(" \t\n;", *p)) {
+	    goto expand;
+	}
+    }
+    cmdPtr->numWords = numWords;
+    return cmdPtr;
+
+  expand:
+    cmdPtr->numWords = numWords;
+    FreeBindCmd(cmdPtr);
+    cmdPtr = (BindCmd *)ckalloc(sizeof(BindCmd));
+    cmdPtr->scriptObj = NULL;
+    cmdPtr->numWords = 0;
+    return cmdPtr;
+}
+
+/*
+ *--------------------------------------------------------------
+ *
+ * FreeBindCmd --
+ *
+ *	Release a compiled binding script.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Memory is freed.
+ *
+ *--------------------------------------------------------------
+ */
+
+static void
+FreeBindCmd(
+    BindCmd *cmdPtr)		/* Compiled script to release, may be NULL. */
+{
+    Tcl_Size i;
+
+    if (!cmdPtr) {
+	return;
+    }
+    if (cmdPtr->scriptObj) {
+	Tcl_DecrRefCount(cmdPtr->scriptObj);
+    }
+    for (i = 0; i < cmdPtr->numWords; ++i) {
+	if (cmdPtr->words[i].literalObj) {
+	    Tcl_DecrRefCount(cmdPtr->words[i].literalObj);
+	}
+    }
+    ckfree(cmdPtr);
+}
+
+/*
+ *--------------------------------------------------------------
+ *
+ * GetBindCmdObj --
+ *
+ *	Produce the command to evaluate for a matching binding, compiling
+ *	the binding script first if this has not been done yet.
+ *
+ * Results:
+ *	The return value is an object holding the command, with its reference
+ *	count already incremented. For scripts of a single simple command it
+ *	is a pure list, which Tcl evaluates without parsing.
+ *
+ * Side effects:
+ *	The compiled script is stored in psPtr.
+ *
+ *--------------------------------------------------------------
+ */
+
+static Tcl_Obj *
+GetBindCmdObj(
+    TkWindow *winPtr,		/* Window where event occurred. */
+    PatSeq *psPtr,		/* Matching binding. */
+    Event *eventPtr,		/* Event containing information to be used in % replacements. */
+    unsigned scriptCount)	/* The number of script-based binding patterns matched so far for
+				 * this event. */
+{
+    BindCmd *cmdPtr;
+    Tcl_Obj *objPtr;
+
+    assert(psPtr->script);
+
+    if (!psPtr->cmdPtr) {
+	psPtr->cmdPtr = CompileBindScript(psPtr->script);
+    }
+    cmdPtr = psPtr->cmdPtr;
+
+    if (cmdPtr->scriptObj) {
+	objPtr = cmdPtr->scriptObj;
+    } else if (cmdPtr->numWords > 0) {
+	Tcl_Size i;
+	Tcl_DString buf;
+
+	Tcl_DStringInit(&buf);
+	objPtr = Tcl_NewListObj(cmdPtr->numWords, NULL);
+	for (i = 0; i < cmdPtr->numWords; ++i) {
+	    BindWord *wordPtr = &cmdPtr->words[i];
+
+	    if (wordPtr->literalObj) {
+		Tcl_ListObjAppendElement(NULL, objPtr, wordPtr->literalObj);
+	    } else {
+		char numStorage[TCL_INTEGER_SPACE];
+		const char *string = GetPercentValue(
+			winPtr, eventPtr, wordPtr->percent, scriptCount, numStorage, &buf);
+
+		Tcl_ListObjAppendElement(NULL, objPtr, Tcl_NewStringObj(string, TCL_INDEX_NONE));
+	    }
+	}
+	Tcl_DStringFree(&buf);
+    } else {
+	Tcl_DString script;
+
+	Tcl_DStringInit(&script);
+	ExpandPercents(winPtr, psPtr->script, eventPtr, scriptCount, &script);
+	objPtr = Tcl_DStringToObj(&script);
+    }
+    Tcl_IncrRefCount(objPtr);
+    return objPtr;
+}
+
 /*
  *----------------------------------------------------------------------
  *
@@ -4786,6 +5082,7 @@ FindSequence(
     psPtr->added = 0;
     psPtr->modMaskUsed = (modMask != 0);
     psPtr->script = NULL;
+    psPtr->cmdPtr = NULL;
     psPtr->nextSeqPtr = (PatSeq *)Tcl_GetHashValue(hPtr);
     psPtr->hPtr = hPtr;
     psPtr->ptr.nextObj = NULL;
@@ -253,6 +253,8 @@ static void		DoItem(Tcl_Obj *accumObj,
 			    Tk_Item *itemPtr, Tk_Uid tag);
 static void		EventuallyRedrawItem(TkCanvas *canvasPtr,
 			    Tk_Item *itemPtr);
+static void		AddRedrawArea(TkCanvas *canvasPtr, int x1, int y1,
+			    int x2, int y2, TkRegion region);
 static int		FindItems(Tcl_Interp *interp, TkCanvas *canvasPtr,
 			    Tcl_Size objc, Tcl_Obj *const *objv,
 			    Tcl_Obj *newTagObj, Tcl_Size first,
@@ -746,6 +748,10 @@ Tk_CanvasObjCmd(
     canvasPtr->tsoffset.xoffset = 0;
     canvasPtr->tsoffset.yoffset = 0;
     canvasPtr->bindTagExprs = NULL;
+    canvasPtr->damageRgn = NULL;
+    canvasPtr->damageRects = 0;
+    canvasPtr->exposeRgn = NULL;
+    canvasPtr->copyGC = NULL;
     Tcl_InitHashTable(&canvasPtr->idTable, TCL_ONE_WORD_KEYS);
 
     Tk_SetClass(canvasPtr->tkwin, "Canvas");
@@ -2217,6 +2223,15 @@ DestroyCanvas(
     if (canvasPtr->pixmapGC != NULL) {
 	Tk_FreeGC(canvasPtr->display, canvasPtr->pixmapGC);
     }
+    if (canvasPtr->copyGC != NULL) {
+	XFreeGC(canvasPtr->display, canvasPtr->copyGC);
+    }
+    if (canvasPtr->damageRgn != NULL) {
+	TkDestroyRegion(canvasPtr->damageRgn);
+    }
+    if (canvasPtr->exposeRgn != NULL) {
+	TkDestroyRegion(canvasPtr->exposeRgn);
+    }
     expr = canvasPtr->bindTagExprs;
     while (expr) {
 	next = expr->next;
@@ -3064,10 +3079,12 @@ DisplayCanvas(
     Pixmap pixmap;
     int screenX1, screenX2, screenY1, screenY2, width, height;
     int borderWidth, highlightWidth;
+    Tcl_WideInt statsStart;
 
     if (canvasPtr->tkwin == NULL) {
 	return;
     }
+    statsStart = TkStatsStart();
 
     if (!Tk_IsMapped(tkwin)) {
 	goto done;
@@ -3236,6 +3253,41 @@ DisplayCanvas(
 		    canvasPtr->canvas_state == TK_STATE_HIDDEN)) {
 		continue;
 	    }
+#ifndef TK_NO_DOUBLE_BUFFERING
+	    if ((canvasPtr->damageRgn != NULL) && !AlwaysRedraw(itemPtr)) {
+		/*
+		 * Skip items which only overlap the bounding box, not the
+		 * area that actually needs redrawing. Coordinates are
+		 * clipped to the screen area, since a region cannot hold
+		 * arbitrary canvas coordinates.
+		 */
+
+		int x1 = itemPtr->x1, y1 = itemPtr->y1;
+		int x2 = itemPtr->x2 + 1, y2 = itemPtr->y2 + 1;
+
+		if (x1 < screenX1) {
+		    x1 = screenX1;
+		}
+		if (y1 < screenY1) {
+		    y1 = screenY1;
+		}
+		if (x2 > screenX2) {
+		    x2 = screenX2;
+		}
+		if (y2 > screenY2) {
+		    y2 = screenY2;
+		}
+		x1 -= canvasPtr->xOrigin;
+		x2 -= canvasPtr->xOrigin;
+		y1 -= canvasPtr->yOrigin;
+		y2 -= canvasPtr->yOrigin;
+		if ((x1 < x2) && (y1 < y2) && (TkRectInRegion(
+			canvasPtr->damageRgn, x1, y1, (unsigned) (x2 - x1),
+			(unsigned) (y2 - y1)) == RectangleOut)) {
+		    continue;
+		}
+	    }
+#endif /* TK_NO_DOUBLE_BUFFERING */
 	    ItemDisplay(canvasPtr, itemPtr, pixmap, screenX1, screenY1, width,
 		    height);
 	}
@@ -3243,15 +3295,34 @@ DisplayCanvas(
 #ifndef TK_NO_DOUBLE_BUFFERING
 	/*
 	 * Copy from the temporary pixmap to the screen, then free up the
-	 * temporary pixmap.
+	 * temporary pixmap. If the exact area to redraw is known, only that
+	 * part is copied, since skipped items were not drawn into the pixmap.
 	 */
 
-	XCopyArea(Tk_Display(tkwin), pixmap, Tk_WindowId(tkwin),
-		canvasPtr->pixmapGC,
-		screenX1 - canvasPtr->drawableXOrigin,
-		screenY1 - canvasPtr->drawableYOrigin,
-		(unsigned int) width, (unsigned int) height,
-		screenX1 - canvasPtr->xOrigin, screenY1 - canvasPtr->yOrigin);
+	if (canvasPtr->damageRgn != NULL) {
+	    if (canvasPtr->copyGC == NULL) {
+		XGCValues gcValues;
+
+		gcValues.graphics_exposures = False;
+		canvasPtr->copyGC = XCreateGC(Tk_Display(tkwin),
+			Tk_WindowId(tkwin), GCGraphicsExposures, &gcValues);
+	    }
+	    TkSetRegion(Tk_Display(tkwin), canvasPtr->copyGC,
+		    canvasPtr->damageRgn);
+	    XCopyArea(Tk_Display(tkwin), pixmap, Tk_WindowId(tkwin),
+		    canvasPtr->copyGC,
+		    screenX1 - canvasPtr->drawableXOrigin,
+		    screenY1 - canvasPtr->drawableYOrigin,
+		    (unsigned int) width, (unsigned int) height,
+		    screenX1 - canvasPtr->xOrigin, screenY1 - canvasPtr->yOrigin);
+	} else {
+	    XCopyArea(Tk_Display(tkwin), pixmap, Tk_WindowId(tkwin),
+		    canvasPtr->pixmapGC,
+		    screenX1 - canvasPtr->drawableXOrigin,
+		    screenY1 - canvasPtr->drawableYOrigin,
+		    (unsigned int) width, (unsigned int) height,
+		    screenX1 - canvasPtr->xOrigin, screenY1 - canvasPtr->yOrigin);
+	}
 	Tk_FreePixmap(Tk_Display(tkwin), pixmap);
 #else
 	Tk_ClipDrawableToRect(Tk_Display(tkwin), pixmap, 0, 0, -1, -1);
@@ -3295,6 +3366,14 @@ DisplayCanvas(
     canvasPtr->flags &= ~(REDRAW_PENDING|BBOX_NOT_EMPTY);
     canvasPtr->redrawX1 = canvasPtr->redrawX2 = 0;
     canvasPtr->redrawY1 = canvasPtr->redrawY2 = 0;
+    if (canvasPtr->damageRgn != NULL) {
+	TkDestroyRegion(canvasPtr->damageRgn);
+	canvasPtr->damageRgn = NULL;
+    }
+    canvasPtr->damageRects = 0;
+    if (statsStart != 0) {
+	TkStatsRecord(TK_STATS_REDISPLAY, Tk_Class(tkwin), statsStart);
+    }
     if (canvasPtr->flags & UPDATE_SCROLLBARS) {
 	CanvasUpdateScrollbars(canvasPtr);
     }
@@ -3326,21 +3405,38 @@ CanvasEventProc(
     TkCanvas *canvasPtr = (TkCanvas *)clientData;
 
     if (eventPtr->type == Expose) {
-	int x, y;
-
-	x = eventPtr->xexpose.x + canvasPtr->xOrigin;
-	y = eventPtr->xexpose.y + canvasPtr->yOrigin;
-	Tk_CanvasEventuallyRedraw((Tk_Canvas) canvasPtr, x, y,
-		x + eventPtr->xexpose.width,
-		y + eventPtr->xexpose.height);
-	if ((eventPtr->xexpose.x < canvasPtr->inset)
-		|| (eventPtr->xexpose.y < canvasPtr->inset)
-		|| ((eventPtr->xexpose.x + eventPtr->xexpose.width)
-		    > (Tk_Width(canvasPtr->tkwin) - canvasPtr->inset))
-		|| ((eventPtr->xexpose.y + eventPtr->xexpose.height)
-		    > (Tk_Height(canvasPtr->tkwin) - canvasPtr->inset))) {
-	    canvasPtr->flags |= REDRAW_BORDERS;
+	TkRegion region;
+	XRectangle rect;
+
+	/*
+	 * Wait for the whole series of Expose events, then redraw exactly
+	 * the exposed area rather than its bounding box.
+	 */
+
+	region = TkAccumulateExpose(&canvasPtr->exposeRgn, eventPtr);
+	if (region == NULL) {
+	    return;
+	}
+	TkClipBox(region, &rect);
+	if (canvasPtr->tkwin != NULL) {
+	    AddRedrawArea(canvasPtr, rect.x + canvasPtr->xOrigin,
+		    rect.y + canvasPtr->yOrigin,
+		    rect.x + rect.width + canvasPtr->xOrigin,
+		    rect.y + rect.height + canvasPtr->yOrigin, region);
+	    if (!(canvasPtr->flags & REDRAW_PENDING)) {
+		TkScheduleRedraw(canvasPtr->tkwin, DisplayCanvas, canvasPtr);
+		canvasPtr->flags |= REDRAW_PENDING;
+	    }
+	    if ((rect.x < canvasPtr->inset)
+		    || (rect.y < canvasPtr->inset)
+		    || ((rect.x + rect.width)
+			> (Tk_Width(canvasPtr->tkwin) - canvasPtr->inset))
+		    || ((rect.y + rect.height)
+			> (Tk_Height(canvasPtr->tkwin) - canvasPtr->inset))) {
+		canvasPtr->flags |= REDRAW_BORDERS;
+	    }
 	}
+	TkDestroyRegion(region);
     } else if (eventPtr->type == DestroyNotify) {
 	if (canvasPtr->tkwin != NULL) {
 	    canvasPtr->tkwin = NULL;
@@ -3348,7 +3444,7 @@ CanvasEventProc(
 		    canvasPtr->widgetCmd);
 	}
 	if (canvasPtr->flags & REDRAW_PENDING) {
-	    Tcl_CancelIdleCall(DisplayCanvas, canvasPtr);
+	    TkCancelRedraw(DisplayCanvas, canvasPtr);
 	}
 	Tcl_EventuallyFree(canvasPtr, DestroyCanvas);
     } else if (eventPtr->type == ConfigureNotify) {
@@ -3471,28 +3567,9 @@ Tk_CanvasEventuallyRedraw(
 	    (y1 >= canvasPtr->yOrigin + Tk_Height(canvasPtr->tkwin))) {
 	return;
     }
-    if (canvasPtr->flags & BBOX_NOT_EMPTY) {
-	if (x1 <= canvasPtr->redrawX1) {
-	    canvasPtr->redrawX1 = x1;
-	}
-	if (y1 <= canvasPtr->redrawY1) {
-	    canvasPtr->redrawY1 = y1;
-	}
-	if (x2 >= canvasPtr->redrawX2) {
-	    canvasPtr->redrawX2 = x2;
-	}
-	if (y2 >= canvasPtr->redrawY2) {
-	    canvasPtr->redrawY2 = y2;
-	}
-    } else {
-	canvasPtr->redrawX1 = x1;
-	canvasPtr->redrawY1 = y1;
-	canvasPtr->redrawX2 = x2;
-	canvasPtr->redrawY2 = y2;
-	canvasPtr->flags |= BBOX_NOT_EMPTY;
-    }
+    AddRedrawArea(canvasPtr, x1, y1, x2, y2, NULL);
     if (!(canvasPtr->flags & REDRAW_PENDING)) {
-	Tcl_DoWhenIdle(DisplayCanvas, canvasPtr);
+	TkScheduleRedraw(canvasPtr->tkwin, DisplayCanvas, canvasPtr);
 	canvasPtr->flags |= REDRAW_PENDING;
     }
 }
@@ -3533,34 +3610,122 @@ EventuallyRedrawItem(
 	}
     }
     if (!(itemPtr->redraw_flags & FORCE_REDRAW)) {
-	if (canvasPtr->flags & BBOX_NOT_EMPTY) {
-	    if (itemPtr->x1 <= canvasPtr->redrawX1) {
-		canvasPtr->redrawX1 = itemPtr->x1;
-	    }
-	    if (itemPtr->y1 <= canvasPtr->redrawY1) {
-		canvasPtr->redrawY1 = itemPtr->y1;
-	    }
-	    if (itemPtr->x2 >= canvasPtr->redrawX2) {
-		canvasPtr->redrawX2 = itemPtr->x2;
-	    }
-	    if (itemPtr->y2 >= canvasPtr->redrawY2) {
-		canvasPtr->redrawY2 = itemPtr->y2;
-	    }
-	} else {
-	    canvasPtr->redrawX1 = itemPtr->x1;
-	    canvasPtr->redrawY1 = itemPtr->y1;
-	    canvasPtr->redrawX2 = itemPtr->x2;
-	    canvasPtr->redrawY2 = itemPtr->y2;
-	    canvasPtr->flags |= BBOX_NOT_EMPTY;
-	}
+	AddRedrawArea(canvasPtr, itemPtr->x1, itemPtr->y1, itemPtr->x2,
+		itemPtr->y2, NULL);
 	itemPtr->redraw_flags |= FORCE_REDRAW;
     }
     if (!(canvasPtr->flags & REDRAW_PENDING)) {
-	Tcl_DoWhenIdle(DisplayCanvas, canvasPtr);
+	TkScheduleRedraw(canvasPtr->tkwin, DisplayCanvas, canvasPtr);
 	canvasPtr->flags |= REDRAW_PENDING;
     }
 }
 
+/*
+ *----------------------------------------------------------------------
+ *
+ * AddRedrawArea --
+ *
+ *	Add an area to the part of the canvas that will be redrawn by the
+ *	next call to DisplayCanvas. The bounding box of all areas decides
+ *	the size of the pixmap; the exact areas, as far as they are visible,
+ *	are also collected in damageRgn so that items outside of them can be
+ *	skipped. After MAX_DAMAGE_RECTS areas the region has become too
+ *	fragmented to be worth it, and only the bounding box is used.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Updates the redraw bounding box and damageRgn. Does not schedule the
+ *	redisplay.
+ *
+ *----------------------------------------------------------------------
+ */
+
+#define MAX_DAMAGE_RECTS 64
+
+static void
+AddRedrawArea(
+    TkCanvas *canvasPtr,	/* Information about widget. */
+    int x1, int y1,		/* Upper left corner of area, in canvas
+				 * coordinates. */
+    int x2, int y2,		/* Lower right corner of area (exclusive). */
+    TkRegion region)		/* Exact area within x1..y2, in window
+				 * coordinates, or NULL for the whole
+				 * rectangle. */
+{
+    if (canvasPtr->flags & BBOX_NOT_EMPTY) {
+	if (x1 <= canvasPtr->redrawX1) {
+	    canvasPtr->redrawX1 = x1;
+	}
+	if (y1 <= canvasPtr->redrawY1) {
+	    canvasPtr->redrawY1 = y1;
+	}
+	if (x2 >= canvasPtr->redrawX2) {
+	    canvasPtr->redrawX2 = x2;
+	}
+	if (y2 >= canvasPtr->redrawY2) {
+	    canvasPtr->redrawY2 = y2;
+	}
+    } else {
+	canvasPtr->redrawX1 = x1;
+	canvasPtr->redrawY1 = y1;
+	canvasPtr->redrawX2 = x2;
+	canvasPtr->redrawY2 = y2;
+	canvasPtr->flags |= BBOX_NOT_EMPTY;
+    }
+
+    if (canvasPtr->damageRects < 0) {
+	return;
+    }
+    if (++canvasPtr->damageRects > MAX_DAMAGE_RECTS) {
+	if (canvasPtr->damageRgn != NULL) {
+	    TkDestroyRegion(canvasPtr->damageRgn);
+	    canvasPtr->damageRgn = NULL;
+	}
+	canvasPtr->damageRects = -1;
+	return;
+    }
+    if (canvasPtr->damageRgn == NULL) {
+	canvasPtr->damageRgn = TkCreateRegion();
+    }
+    if (region != NULL) {
+	TkUnionRegion(canvasPtr->damageRgn, region, canvasPtr->damageRgn);
+    } else {
+	XRectangle rect;
+
+	/*
+	 * Clip to the window, since a region cannot hold arbitrary canvas
+	 * coordinates.
+	 */
+
+	x1 -= canvasPtr->xOrigin;
+	y1 -= canvasPtr->yOrigin;
+	x2 -= canvasPtr->xOrigin;
+	y2 -= canvasPtr->yOrigin;
+	if (x1 < 0) {
+	    x1 = 0;
+	}
+	if (y1 < 0) {
+	    y1 = 0;
+	}
+	if (x2 > Tk_Width(canvasPtr->tkwin)) {
+	    x2 = Tk_Width(canvasPtr->tkwin);
+	}
+	if (y2 > Tk_Height(canvasPtr->tkwin)) {
+	    y2 = Tk_Height(canvasPtr->tkwin);
+	}
+	if ((x1 < x2) && (y1 < y2)) {
+	    rect.x = (short) x1;
+	    rect.y = (short) y1;
+	    rect.width = (unsigned short) (x2 - x1);
+	    rect.height = (unsigned short) (y2 - y1);
+	    TkUnionRectWithRegion(&rect, canvasPtr->damageRgn,
+		    canvasPtr->damageRgn);
+	}
+    }
+}
+
 /*
  *----------------------------------------------------------------------
  *
@@ -5680,7 +5845,7 @@ CanvasFocusProc(
     if (highlightWidth > 0) {
 	canvasPtr->flags |= REDRAW_BORDERS;
 	if (!(canvasPtr->flags & REDRAW_PENDING)) {
-	    Tcl_DoWhenIdle(DisplayCanvas, canvasPtr);
+	    TkScheduleRedraw(canvasPtr->tkwin, DisplayCanvas, canvasPtr);
 	    canvasPtr->flags |= REDRAW_PENDING;
 	}
     }
@@ -233,6 +233,23 @@ typedef struct TkCanvas {
     TagSearchExpr *bindTagExprs;/* Linked list of tag expressions used in
 				 * bindings. */
 #endif
+
+    /*
+     * Exact area to redraw, kept alongside the bounding box above:
+     */
+
+    TkRegion damageRgn;		/* Area that needs to be redrawn, in window
+				 * coordinates; always inside the bounding box
+				 * redrawX1..redrawY2. NULL means the whole
+				 * bounding box is redrawn. */
+    int damageRects;		/* Number of areas added to damageRgn since
+				 * the last redisplay, or -1 if there were too
+				 * many and damageRgn was given up. */
+    TkRegion exposeRgn;		/* Area of the current series of Expose
+				 * events, see TkAccumulateExpose. */
+    GC copyGC;			/* Private GC used to copy the pixmap to the
+				 * screen, clipped to damageRgn. NULL until
+				 * first needed. */
 } TkCanvas;
 
 /*
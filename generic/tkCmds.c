@@ -38,10 +38,16 @@ static int		AppnameCmd(void *dummy, Tcl_Interp *interp,
 			    Tcl_Size objc, Tcl_Obj *const *objv);
 static int		CaretCmd(void *dummy, Tcl_Interp *interp,
 			    Tcl_Size objc, Tcl_Obj *const *objv);
+static int		CoalesceCmd(void *dummy, Tcl_Interp *interp,
+			    Tcl_Size objc, Tcl_Obj *const *objv);
+static int		FramerateCmd(void *dummy, Tcl_Interp *interp,
+			    Tcl_Size objc, Tcl_Obj *const *objv);
 static int		InactiveCmd(void *dummy, Tcl_Interp *interp,
 			    Tcl_Size objc, Tcl_Obj *const *objv);
 static int		ScalingCmd(void *dummy, Tcl_Interp *interp,
 			    Tcl_Size objc, Tcl_Obj *const *objv);
+static int		StatsCmd(void *dummy, Tcl_Interp *interp,
+			    Tcl_Size objc, Tcl_Obj *const *objv);
 static int		UseinputmethodsCmd(void *dummy,
 			    Tcl_Interp *interp, Tcl_Size objc,
 			    Tcl_Obj *const *objv);
@@ -64,8 +70,11 @@ static const TkEnsemble tkCmdMap[] = {
     {"appname",		AppnameCmd, NULL },
     {"busy",		Tk_BusyObjCmd, NULL },
     {"caret",		CaretCmd, NULL },
+    {"coalesce",	CoalesceCmd, NULL },
+    {"framerate",	FramerateCmd, NULL },
     {"inactive",	InactiveCmd, NULL },
     {"scaling",		ScalingCmd, NULL },
+    {"stats",		StatsCmd, NULL },
     {"useinputmethods",	UseinputmethodsCmd, NULL },
     {"windowingsystem",	WindowingsystemCmd, NULL },
     {NULL, NULL, NULL}
@@ -664,8 +673,8 @@ TkInitTkCmd(
 /*
  *----------------------------------------------------------------------
  *
- * AppnameCmd, CaretCmd, ScalingCmd, UseinputmethodsCmd,
- * WindowingsystemCmd, InactiveCmd --
+ * AppnameCmd, CaretCmd, CoalesceCmd, FramerateCmd, ScalingCmd, StatsCmd,
+ * UseinputmethodsCmd, WindowingsystemCmd, InactiveCmd --
  *
  *	These functions are invoked to process the "tk" ensemble subcommands.
  *	See the user documentation for details on what they do.
@@ -803,6 +812,113 @@ CaretCmd(
     return TCL_OK;
 }
 
+int
+CoalesceCmd(
+    void *clientData,		/* Main window associated with interpreter. */
+    Tcl_Interp *interp,		/* Current interpreter. */
+    Tcl_Size objc,		/* Number of arguments. */
+    Tcl_Obj *const objv[])	/* Argument objects. */
+{
+    static const char *const typeStrings[] = {
+	"Motion", "Configure", "Expose", "MouseWheel", NULL
+    };
+    Tk_Window tkwin = (Tk_Window)clientData;
+    TkWindow *winPtr = NULL;
+    TkDisplay *dispPtr;
+    Tcl_Obj *resultObj;
+    Tcl_Size skip, i;
+    int mask;
+
+    if ((objc > 2) && !strcmp(Tcl_GetString(objv[1]), "-window")) {
+	tkwin = Tk_NameToWindow(interp, Tcl_GetString(objv[2]), tkwin);
+	if (tkwin == NULL) {
+	    return TCL_ERROR;
+	}
+	winPtr = (TkWindow *) tkwin;
+	skip = 2;
+    } else {
+	skip = TkGetDisplayOf(interp, objc - 1, objv + 1, &tkwin);
+	if (skip < 0) {
+	    return TCL_ERROR;
+	}
+    }
+    dispPtr = ((TkWindow *) tkwin)->dispPtr;
+
+    if (objc == 2 + skip) {
+	Tcl_Size listc;
+	Tcl_Obj **listv;
+	int index;
+
+	if (winPtr && !strcmp(Tcl_GetString(objv[1+skip]), "default")) {
+	    winPtr->coalesceMask = -1;
+	} else {
+	    if (Tcl_ListObjGetElements(interp, objv[1+skip], &listc,
+		    &listv) != TCL_OK) {
+		return TCL_ERROR;
+	    }
+	    mask = 0;
+	    for (i = 0; i < listc; i++) {
+		if (Tcl_GetIndexFromObj(interp, listv[i], typeStrings,
+			"event type", 0, &index) != TCL_OK) {
+		    return TCL_ERROR;
+		}
+		mask |= 1 << index;
+	    }
+	    if (winPtr) {
+		winPtr->coalesceMask = mask;
+		dispPtr->flags |= TK_DISPLAY_COALESCE_WINDOWS;
+	    } else {
+		dispPtr->coalesceMask = mask;
+	    }
+	}
+    } else if (objc != 1 + skip) {
+	Tcl_WrongNumArgs(interp, 1, objv,
+		"?-displayof window|-window window? ?typeList?");
+	return TCL_ERROR;
+    }
+
+    mask = (winPtr && winPtr->coalesceMask >= 0)
+	    ? winPtr->coalesceMask : dispPtr->coalesceMask;
+    resultObj = Tcl_NewObj();
+    for (i = 0; typeStrings[i] != NULL; i++) {
+	if (mask & (1 << i)) {
+	    Tcl_ListObjAppendElement(NULL, resultObj,
+		    Tcl_NewStringObj(typeStrings[i], TCL_INDEX_NONE));
+	}
+    }
+    Tcl_SetObjResult(interp, resultObj);
+    return TCL_OK;
+}
+
+int
+FramerateCmd(
+    TCL_UNUSED(void *),
+    Tcl_Interp *interp,		/* Current interpreter. */
+    Tcl_Size objc,		/* Number of arguments. */
+    Tcl_Obj *const objv[])	/* Argument objects. */
+{
+    int rate;
+
+    if (objc == 2) {
+	if (Tcl_GetIntFromObj(interp, objv[1], &rate) != TCL_OK) {
+	    return TCL_ERROR;
+	}
+	if (rate < 0) {
+	    Tcl_SetObjResult(interp, Tcl_ObjPrintf(
+		    "bad frame rate \"%d\": must be a non-negative integer",
+		    rate));
+	    Tcl_SetErrorCode(interp, "TK", "VALUE", "FRAMERATE", (char *)NULL);
+	    return TCL_ERROR;
+	}
+	TkSetFrameRate(rate);
+    } else if (objc != 1) {
+	Tcl_WrongNumArgs(interp, 1, objv, "?rate?");
+	return TCL_ERROR;
+    }
+    Tcl_SetObjResult(interp, Tcl_NewIntObj(TkGetFrameRate()));
+    return TCL_OK;
+}
+
 int
 ScalingCmd(
     void *clientData,		/* Main window associated with interpreter. */
@@ -946,6 +1062,52 @@ WindowingsystemCmd(
     return TCL_OK;
 }
 
+int
+StatsCmd(
+    TCL_UNUSED(void *),
+    Tcl_Interp *interp,		/* Current interpreter. */
+    Tcl_Size objc,		/* Number of arguments. */
+    Tcl_Obj *const objv[])	/* Argument objects. */
+{
+    static const char *const optionStrings[] = {
+	"disable", "enable", "reset", NULL
+    };
+    enum options {
+	STATS_DISABLE, STATS_ENABLE, STATS_RESET
+    };
+    int index;
+
+    if (objc == 1) {
+	Tcl_Obj *resultObj = TkStatsGetObj();
+
+	Tcl_DictObjPut(NULL, resultObj,
+		Tcl_NewStringObj("enabled", TCL_INDEX_NONE),
+		Tcl_NewBooleanObj(tkStatsEnabled));
+	Tcl_SetObjResult(interp, resultObj);
+	return TCL_OK;
+    }
+    if (objc != 2) {
+	Tcl_WrongNumArgs(interp, 1, objv, "?enable|disable|reset?");
+	return TCL_ERROR;
+    }
+    if (Tcl_GetIndexFromObj(interp, objv[1], optionStrings, "option", 0,
+	    &index) != TCL_OK) {
+	return TCL_ERROR;
+    }
+    switch ((enum options) index) {
+    case STATS_DISABLE:
+	tkStatsEnabled = 0;
+	break;
+    case STATS_ENABLE:
+	tkStatsEnabled = 1;
+	break;
+    case STATS_RESET:
+	TkStatsReset();
+	break;
+    }
+    return TCL_OK;
+}
+
 int
 InactiveCmd(
     void *clientData,		/* Main window associated with interpreter. */
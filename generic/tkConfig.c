@@ -86,6 +86,13 @@ typedef struct TkOption {
     Tk_Uid dbClassUID;		/* The Uid form of the option database class
 				 * name. */
     Tcl_Obj *defaultPtr;	/* Default value for this option. */
+    Tk_Uid dbValueUID;		/* The option database value most recently
+				 * used to initialize this option, or NULL. */
+    Tcl_Obj *dbValuePtr;	/* Object holding dbValueUID. It is shared by
+				 * all records initialized from that value, so
+				 * that the resource (color, font, ...) cached
+				 * in its internal representation is resolved
+				 * only once rather than once per widget. */
     union {
 	Tcl_Obj *monoColorPtr;	/* For color and border options, this is an
 				 * alternate default value to use on
@@ -264,6 +271,8 @@ Tk_CreateOptionTable(
 	optionPtr->dbNameUID = NULL;
 	optionPtr->dbClassUID = NULL;
 	optionPtr->defaultPtr = NULL;
+	optionPtr->dbValueUID = NULL;
+	optionPtr->dbValuePtr = NULL;
 	optionPtr->extra.monoColorPtr = NULL;
 	optionPtr->flags = 0;
 
@@ -377,6 +386,9 @@ Tk_DeleteOptionTable(
 	if (optionPtr->defaultPtr != NULL) {
 	    Tcl_DecrRefCount(optionPtr->defaultPtr);
 	}
+	if (optionPtr->dbValuePtr != NULL) {
+	    Tcl_DecrRefCount(optionPtr->dbValuePtr);
+	}
 	if (((optionPtr->specPtr->type == TK_OPTION_COLOR)
 		|| (optionPtr->specPtr->type == TK_OPTION_BORDER))
 		&& (optionPtr->extra.monoColorPtr != NULL)) {
@@ -476,7 +488,23 @@ Tk_InitOptions(
 	    value = Tk_GetOption(tkwin, optionPtr->dbNameUID,
 		    optionPtr->dbClassUID);
 	    if (value != NULL) {
-		valuePtr = Tcl_NewStringObj(value, TCL_INDEX_NONE);
+		/*
+		 * Widgets of a class usually get the same database value for
+		 * an option. Reuse the object made for the previous one, whose
+		 * internal representation already refers to the converted
+		 * resource.
+		 */
+
+		if (value != optionPtr->dbValueUID) {
+		    if (optionPtr->dbValuePtr != NULL) {
+			Tcl_DecrRefCount(optionPtr->dbValuePtr);
+		    }
+		    optionPtr->dbValueUID = value;
+		    optionPtr->dbValuePtr =
+			    Tcl_NewStringObj(value, TCL_INDEX_NONE);
+		    Tcl_IncrRefCount(optionPtr->dbValuePtr);
+		}
+		valuePtr = optionPtr->dbValuePtr;
 		source = OPTION_DATABASE;
 	    }
 	}
@@ -1647,6 +1647,7 @@ DisplayEntry(
     Pixmap pixmap;
     Tk_3DBorder border;
     int borderWidth, selBorderWidth, insertWidth, highlightWidth;
+    Tcl_WideInt statsStart;
 
     entryPtr->flags &= ~REDRAW_PENDING;
     if ((entryPtr->flags & ENTRY_DELETED) || !Tk_IsMapped(tkwin)) {
@@ -1676,6 +1677,7 @@ DisplayEntry(
 	}
 	Tcl_Release(entryPtr);
     }
+    statsStart = TkStatsStart();
 
 #ifndef TK_NO_DOUBLE_BUFFERING
     /*
@@ -1975,6 +1977,9 @@ DisplayEntry(
     Tk_FreePixmap(entryPtr->display, pixmap);
 #endif /* TK_NO_DOUBLE_BUFFERING */
     entryPtr->flags &= ~BORDER_NEEDED;
+    if (statsStart != 0) {
+	TkStatsRecord(TK_STATS_REDISPLAY, Tk_Class(tkwin), statsStart);
+    }
 }
 
 /*
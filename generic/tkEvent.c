@@ -139,6 +139,75 @@ typedef struct ExitHandler {
 				 * application, or NULL for end of list. */
 } ExitHandler;
 
+/*
+ * Timings collected for "tk stats". There is one of these structures for
+ * each category, and one for each window class within a category.
+ * Histogram bucket 0 counts durations below 1 microsecond, bucket i those
+ * from 2^(i-1) up to 2^i microseconds, and the last bucket everything
+ * longer.
+ */
+
+#define STATS_BUCKETS 16
+
+typedef struct {
+    Tcl_WideInt count;		/* Number of measured calls. */
+    Tcl_WideInt total;		/* Sum of their durations, in microseconds. */
+    Tcl_WideInt max;		/* Longest duration, in microseconds. */
+    Tcl_WideInt histogram[STATS_BUCKETS];
+} StatsEntry;
+
+typedef struct {
+    StatsEntry all;		/* All calls in this category. */
+    Tcl_HashTable classTable;	/* StatsEntry for each window class, keyed
+				 * by class Tk_Uid (NULL for windows without
+				 * a class). */
+} StatsCategory;
+
+/*
+ * Redisplay requested through TkScheduleRedraw while frame pacing is on.
+ */
+
+typedef struct {
+    Tcl_IdleProc *proc;		/* Redisplay function, or NULL if the request
+				 * was cancelled or has been run. */
+    void *clientData;		/* Argument for proc. */
+    int depth;			/* Depth of the window in its hierarchy, so
+				 * that parents are redrawn first. */
+    Tcl_Size seq;		/* Order of the request within a depth. */
+} PendingRedraw;
+
+/*
+ * Geometry manager relayout requested through TkScheduleLayout. The same
+ * structure serves, since requests are also run by depth.
+ */
+
+typedef PendingRedraw PendingLayout;
+
+/*
+ * The requests being run by a frame or a layout pass. Each takes ownership of
+ * the pending requests before running them, so that frames and passes
+ * entered recursively (through "update" in a script run by a redisplay or
+ * layout function) work on their own requests. Active batches are chained
+ * so that TkCancelRedraw and TkCancelLayout can reach all of them.
+ */
+
+typedef struct RequestBatch {
+    PendingRedraw *requests;	/* Requests being run. */
+    Tcl_Size numRequests;	/* Number of entries in requests. */
+    struct RequestBatch *nextPtr;
+				/* Batch of the enclosing frame or pass, or
+				 * NULL. */
+} RequestBatch;
+
+/*
+ * Set while "tk stats" timing is enabled. The flag is shared by all threads,
+ * each of which collects its own timings, and is read without locking on
+ * every measured call: a thread may notice a change a few calls late, which
+ * only means those calls are timed or not. Nothing else depends on it.
+ */
+
+int tkStatsEnabled = 0;
+
 /*
  * The structure below is used to store Data for the Event module that must be
  * kept thread-local. The "dataKey" is used to fetch the thread-specific
@@ -180,7 +249,42 @@ typedef struct {
     int inExit;			/* True when this thread is exiting. This is
 				 * used as a hack to decide to close the
 				 * standard channels. */
+    StatsCategory *statsPtr;	/* Array of TK_STATS_CATEGORIES timings for
+				 * "tk stats", or NULL if nothing was measured
+				 * in this thread yet. */
+
+    /*
+     * Frame pacing of widget redisplay, see TkScheduleRedraw.
+     */
+
+    int frameInterval;		/* Time between frames in microseconds, or 0
+				 * if redisplay is not paced. */
+    Tcl_WideInt lastFrame;	/* Start of the previous frame. */
+    int framePending;		/* FRAME_TIMER or FRAME_IDLE if the next frame
+				 * has been scheduled, else 0. */
+    Tcl_TimerToken frameTimer;	/* Timer for the next frame. */
+    PendingRedraw *redraws;	/* Requests for the next frame. */
+    Tcl_Size numRedraws;	/* Number of used entries in redraws. */
+    Tcl_Size redrawSpace;	/* Number of allocated entries in redraws. */
+    RequestBatch *frameBatchPtr;/* Batch of the innermost frame being run,
+				 * or NULL. */
+
+    /*
+     * Coalesced geometry management, see TkScheduleLayout.
+     */
+
+    PendingLayout *layouts;	/* Relayout requests for the next pass. */
+    Tcl_Size numLayouts;	/* Number of used entries in layouts. */
+    Tcl_Size layoutSpace;	/* Number of allocated entries in layouts. */
+    int layoutPending;		/* Non-zero if LayoutIdleProc has been
+				 * scheduled. */
+    RequestBatch *layoutBatchPtr;
+				/* Batch of the innermost layout pass being
+				 * run, or NULL. */
 } ThreadSpecificData;
+
+#define FRAME_TIMER	1
+#define FRAME_IDLE	2
 static Tcl_ThreadDataKey dataKey;
 
 /*
@@ -207,6 +311,17 @@ static int		InvokeFocusHandlers(TkWindow **winPtrPtr,
 			    unsigned long mask, XEvent *eventPtr);
 static int		InvokeGenericHandlers(ThreadSpecificData *tsdPtr,
 			    XEvent *eventPtr);
+static void		AddLayout(ThreadSpecificData *tsdPtr,
+			    Tcl_IdleProc *proc, void *clientData, int depth);
+static void		CancelRequests(PendingRedraw *requests,
+			    Tcl_Size numRequests, Tcl_IdleProc *proc,
+			    void *clientData);
+static int		CompareLayouts(const void *first, const void *second);
+static int		CompareRedraws(const void *first, const void *second);
+static void		FrameIdleProc(void *clientData);
+static void		FrameTimerProc(void *clientData);
+static void		FreeStats(ThreadSpecificData *tsdPtr);
+static void		LayoutIdleProc(void *clientData);
 static int		InvokeMouseHandlers(TkWindow *winPtr,
 			    unsigned long mask, XEvent *eventPtr);
 static Window		ParentXId(Display *display, Window w);
@@ -1104,6 +1219,8 @@ Tk_HandleEvent(
     unsigned long mask;
     InProgress ip;
     Tcl_Interp *interp = NULL;
+    Tcl_WideInt statsStart = TkStatsStart();
+    Tk_Uid statsClass = NULL;
     ThreadSpecificData *tsdPtr = (ThreadSpecificData *)
 	    Tcl_GetThreadData(&dataKey, sizeof(ThreadSpecificData));
 
@@ -1162,6 +1279,7 @@ Tk_HandleEvent(
 	    && (eventPtr->type != DestroyNotify)) {
 	goto releaseEventResources;
     }
+    statsClass = winPtr->classUid;
 
     if (winPtr->mainPtr != NULL) {
 	int result;
@@ -1287,6 +1405,9 @@ Tk_HandleEvent(
     if (interp != NULL) {
 	Tcl_Release(interp);
     }
+    if (statsStart != 0) {
+	TkStatsRecord(TK_STATS_EVENT, statsClass, statsStart);
+    }
 
     /*
      * Release the user_data from the event (if it is a virtual event and the
@@ -2066,7 +2187,805 @@ TkFinalizeThread(
 	    exitPtr->proc(exitPtr->clientData);
 	    ckfree(exitPtr);
 	}
+	FreeStats(tsdPtr);
+	if (tsdPtr->framePending == FRAME_TIMER) {
+	    Tcl_DeleteTimerHandler(tsdPtr->frameTimer);
+	} else if (tsdPtr->framePending == FRAME_IDLE) {
+	    Tcl_CancelIdleCall(FrameIdleProc, tsdPtr);
+	}
+	tsdPtr->framePending = 0;
+	if (tsdPtr->redraws != NULL) {
+	    ckfree(tsdPtr->redraws);
+	    tsdPtr->redraws = NULL;
+	}
+	tsdPtr->numRedraws = tsdPtr->redrawSpace = 0;
+	if (tsdPtr->layoutPending) {
+	    Tcl_CancelIdleCall(LayoutIdleProc, tsdPtr);
+	    tsdPtr->layoutPending = 0;
+	}
+	if (tsdPtr->layouts != NULL) {
+	    ckfree(tsdPtr->layouts);
+	    tsdPtr->layouts = NULL;
+	}
+	tsdPtr->numLayouts = tsdPtr->layoutSpace = 0;
+    }
+}
+
+/*
+ *----------------------------------------------------------------------
+ *
+ * TkScheduleRedraw --
+ *
+ *	Arranges for a widget's redisplay function to be called. Normally this
+ *	is just Tcl_DoWhenIdle. While frame pacing is on (see
+ *	TkSetFrameRate), the requests of all widgets are collected instead and
+ *	run together once per frame, parents before their descendants, after
+ *	which every display is flushed once.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	proc will be called with clientData at idle time or at the next
+ *	frame. As with Tcl_DoWhenIdle, the caller must avoid duplicate
+ *	requests and cancel them with TkCancelRedraw.
+ *
+ *----------------------------------------------------------------------
+ */
+
+void
+TkScheduleRedraw(
+    Tk_Window tkwin,		/* Window to be redrawn, or NULL. */
+    Tcl_IdleProc *proc,		/* Redisplay function. */
+    void *clientData)		/* Argument for proc. */
+{
+    ThreadSpecificData *tsdPtr = (ThreadSpecificData *)
+	    Tcl_GetThreadData(&dataKey, sizeof(ThreadSpecificData));
+    PendingRedraw *redrawPtr;
+    TkWindow *winPtr;
+    int depth = 0;
+
+    if (tsdPtr->frameInterval == 0) {
+	Tcl_DoWhenIdle(proc, clientData);
+	return;
+    }
+
+    for (winPtr = (TkWindow *) tkwin; winPtr != NULL;
+	    winPtr = winPtr->parentPtr) {
+	depth++;
+    }
+    if (tsdPtr->numRedraws == tsdPtr->redrawSpace) {
+	tsdPtr->redrawSpace = (tsdPtr->redrawSpace > 0)
+		? 2 * tsdPtr->redrawSpace : 16;
+	tsdPtr->redraws = (PendingRedraw *)ckrealloc(tsdPtr->redraws,
+		tsdPtr->redrawSpace * sizeof(PendingRedraw));
+    }
+    redrawPtr = &tsdPtr->redraws[tsdPtr->numRedraws];
+    redrawPtr->proc = proc;
+    redrawPtr->clientData = clientData;
+    redrawPtr->depth = depth;
+    redrawPtr->seq = tsdPtr->numRedraws++;
+
+    if (!tsdPtr->framePending) {
+	Tcl_WideInt delay = tsdPtr->lastFrame + tsdPtr->frameInterval
+		- TkStatsClock();
+
+	if (delay > 0) {
+	    tsdPtr->frameTimer = Tcl_CreateTimerHandler(
+		    (int) ((delay + 999) / 1000), FrameTimerProc, tsdPtr);
+	    tsdPtr->framePending = FRAME_TIMER;
+	} else {
+	    Tcl_DoWhenIdle(FrameIdleProc, tsdPtr);
+	    tsdPtr->framePending = FRAME_IDLE;
+	}
+    }
+}
+
+/*
+ *----------------------------------------------------------------------
+ *
+ * TkCancelRedraw --
+ *
+ *	Cancels a request made with TkScheduleRedraw, whether it is waiting
+ *	for idle time or for the next frame.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	proc will not be called with clientData.
+ *
+ *----------------------------------------------------------------------
+ */
+
+void
+TkCancelRedraw(
+    Tcl_IdleProc *proc,		/* Redisplay function. */
+    void *clientData)		/* Argument for proc. */
+{
+    ThreadSpecificData *tsdPtr = (ThreadSpecificData *)
+	    Tcl_GetThreadData(&dataKey, sizeof(ThreadSpecificData));
+    RequestBatch *batchPtr;
+
+    Tcl_CancelIdleCall(proc, clientData);
+    CancelRequests(tsdPtr->redraws, tsdPtr->numRedraws, proc, clientData);
+    for (batchPtr = tsdPtr->frameBatchPtr; batchPtr != NULL;
+	    batchPtr = batchPtr->nextPtr) {
+	CancelRequests(batchPtr->requests, batchPtr->numRequests, proc,
+		clientData);
+    }
+}
+
+static void
+CancelRequests(
+    PendingRedraw *requests,	/* Array of requests. */
+    Tcl_Size numRequests,	/* Number of entries in requests. */
+    Tcl_IdleProc *proc,		/* Function of the request to cancel. */
+    void *clientData)		/* Argument of the request to cancel. */
+{
+    Tcl_Size i;
+
+    for (i = 0; i < numRequests; i++) {
+	if ((requests[i].proc == proc)
+		&& (requests[i].clientData == clientData)) {
+	    requests[i].proc = NULL;
+	}
+    }
+}
+
+/*
+ *----------------------------------------------------------------------
+ *
+ * TkSetFrameRate, TkGetFrameRate --
+ *
+ *	Set and query the number of frames per second at which widget
+ *	redisplay is paced in the current thread. 0 turns pacing off; any
+ *	redisplay waiting for the next frame is then handed to
+ *	Tcl_DoWhenIdle.
+ *
+ * Results:
+ *	TkGetFrameRate returns the rate, 0 if pacing is off.
+ *
+ * Side effects:
+ *	See above.
+ *
+ *----------------------------------------------------------------------
+ */
+
+void
+TkSetFrameRate(
+    int rate)			/* Frames per second, or 0. */
+{
+    ThreadSpecificData *tsdPtr = (ThreadSpecificData *)
+	    Tcl_GetThreadData(&dataKey, sizeof(ThreadSpecificData));
+    RequestBatch *batchPtr;
+    Tcl_Size i;
+
+    if (rate > 0) {
+	tsdPtr->frameInterval = (rate < 1000000) ? 1000000 / rate : 1;
+	return;
+    }
+    tsdPtr->frameInterval = 0;
+    if (tsdPtr->framePending == FRAME_TIMER) {
+	Tcl_DeleteTimerHandler(tsdPtr->frameTimer);
+    } else if (tsdPtr->framePending == FRAME_IDLE) {
+	Tcl_CancelIdleCall(FrameIdleProc, tsdPtr);
+    }
+    tsdPtr->framePending = 0;
+    for (i = 0; i < tsdPtr->numRedraws; i++) {
+	if (tsdPtr->redraws[i].proc != NULL) {
+	    Tcl_DoWhenIdle(tsdPtr->redraws[i].proc,
+		    tsdPtr->redraws[i].clientData);
+	}
+    }
+    tsdPtr->numRedraws = 0;
+
+    /*
+     * The rest of the frames being run is handed over as well; their loops
+     * skip the cleared entries.
+     */
+
+    for (batchPtr = tsdPtr->frameBatchPtr; batchPtr != NULL;
+	    batchPtr = batchPtr->nextPtr) {
+	for (i = 0; i < batchPtr->numRequests; i++) {
+	    if (batchPtr->requests[i].proc != NULL) {
+		Tcl_DoWhenIdle(batchPtr->requests[i].proc,
+			batchPtr->requests[i].clientData);
+		batchPtr->requests[i].proc = NULL;
+	    }
+	}
+    }
+}
+
+int
+TkGetFrameRate(void)
+{
+    ThreadSpecificData *tsdPtr = (ThreadSpecificData *)
+	    Tcl_GetThreadData(&dataKey, sizeof(ThreadSpecificData));
+
+    if (tsdPtr->frameInterval == 0) {
+	return 0;
+    }
+    return (1000000 + tsdPtr->frameInterval / 2) / tsdPtr->frameInterval;
+}
+
+/*
+ *----------------------------------------------------------------------
+ *
+ * FrameTimerProc, FrameIdleProc --
+ *
+ *	Run one frame: when the frame is due, wait for idle time so that
+ *	pending input is handled first, then call all redisplay functions
+ *	requested so far, parents first, and flush every display once.
+ *	Requests made while the frame runs are left for the next frame.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Widgets are redrawn.
+ *
+ *----------------------------------------------------------------------
+ */
+
+static void
+FrameTimerProc(
+    void *clientData)
+{
+    ThreadSpecificData *tsdPtr = (ThreadSpecificData *)clientData;
+
+    Tcl_DoWhenIdle(FrameIdleProc, tsdPtr);
+    tsdPtr->framePending = FRAME_IDLE;
+}
+
+static int
+CompareRedraws(
+    const void *first,
+    const void *second)
+{
+    const PendingRedraw *r1 = (const PendingRedraw *)first;
+    const PendingRedraw *r2 = (const PendingRedraw *)second;
+
+    if (r1->depth != r2->depth) {
+	return (r1->depth < r2->depth) ? -1 : 1;
+    }
+    return (r1->seq < r2->seq) ? -1 : (r1->seq > r2->seq);
+}
+
+static void
+FrameIdleProc(
+    void *clientData)
+{
+    ThreadSpecificData *tsdPtr = (ThreadSpecificData *)clientData;
+    RequestBatch batch;
+    Tcl_Size i;
+    TkDisplay *dispPtr;
+
+    tsdPtr->framePending = 0;
+    tsdPtr->lastFrame = TkStatsClock();
+
+    /*
+     * Take the pending requests; those made while they run start a new
+     * array and are left for the next frame. Entries are cleared before the
+     * call, so that TkCancelRedraw cannot match them any more.
+     */
+
+    batch.requests = tsdPtr->redraws;
+    batch.numRequests = tsdPtr->numRedraws;
+    batch.nextPtr = tsdPtr->frameBatchPtr;
+    tsdPtr->redraws = NULL;
+    tsdPtr->numRedraws = tsdPtr->redrawSpace = 0;
+    tsdPtr->frameBatchPtr = &batch;
+
+    qsort(batch.requests, batch.numRequests, sizeof(PendingRedraw),
+	    CompareRedraws);
+    for (i = 0; i < batch.numRequests; i++) {
+	Tcl_IdleProc *proc = batch.requests[i].proc;
+
+	if (proc != NULL) {
+	    batch.requests[i].proc = NULL;
+	    proc(batch.requests[i].clientData);
+	}
+    }
+    tsdPtr->frameBatchPtr = batch.nextPtr;
+    if (batch.requests != NULL) {
+	ckfree(batch.requests);
+    }
+
+    for (dispPtr = TkGetDisplayList(); dispPtr != NULL;
+	    dispPtr = dispPtr->nextPtr) {
+	XFlush(dispPtr->display);
+    }
+
+    if ((tsdPtr->numRedraws > 0) && (tsdPtr->frameInterval > 0)
+	    && !tsdPtr->framePending) {
+	tsdPtr->frameTimer = Tcl_CreateTimerHandler(
+		(tsdPtr->frameInterval + 999) / 1000, FrameTimerProc, tsdPtr);
+	tsdPtr->framePending = FRAME_TIMER;
+    }
+}
+
+/*
+ *----------------------------------------------------------------------
+ *
+ * TkScheduleLayout --
+ *
+ *	Arranges for a geometry manager's layout function to be called at
+ *	idle time, like Tcl_DoWhenIdle. All requests pending at idle time are
+ *	run in a single pass, deepest containers first, so that the requested
+ *	sizes of nested containers are settled before their parents arrange
+ *	them. Each layout function runs at most once per pass; a request made
+ *	for a container whose layout has already run in the current pass (for
+ *	instance because its parent has just resized it) is left for the next
+ *	pass.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	proc will be called with clientData at idle time. As with
+ *	Tcl_DoWhenIdle, the caller must avoid duplicate requests and cancel
+ *	them with TkCancelLayout.
+ *
+ *----------------------------------------------------------------------
+ */
+
+void
+TkScheduleLayout(
+    Tk_Window tkwin,		/* Container to be arranged. */
+    Tcl_IdleProc *proc,		/* Layout function. */
+    void *clientData)		/* Argument for proc. */
+{
+    ThreadSpecificData *tsdPtr = (ThreadSpecificData *)
+	    Tcl_GetThreadData(&dataKey, sizeof(ThreadSpecificData));
+    TkWindow *winPtr;
+    int depth = 0;
+
+    for (winPtr = (TkWindow *) tkwin; winPtr != NULL;
+	    winPtr = winPtr->parentPtr) {
+	depth++;
+    }
+    AddLayout(tsdPtr, proc, clientData, depth);
+
+    if (!tsdPtr->layoutPending) {
+	Tcl_DoWhenIdle(LayoutIdleProc, tsdPtr);
+	tsdPtr->layoutPending = 1;
+    }
+}
+
+static void
+AddLayout(
+    ThreadSpecificData *tsdPtr,
+    Tcl_IdleProc *proc,		/* Layout function. */
+    void *clientData,		/* Argument for proc. */
+    int depth)			/* Depth of the container in the window
+				 * hierarchy. */
+{
+    PendingLayout *layoutPtr;
+
+    if (tsdPtr->numLayouts == tsdPtr->layoutSpace) {
+	tsdPtr->layoutSpace = (tsdPtr->layoutSpace > 0)
+		? 2 * tsdPtr->layoutSpace : 16;
+	tsdPtr->layouts = (PendingLayout *)ckrealloc(tsdPtr->layouts,
+		tsdPtr->layoutSpace * sizeof(PendingLayout));
+    }
+    layoutPtr = &tsdPtr->layouts[tsdPtr->numLayouts];
+    layoutPtr->proc = proc;
+    layoutPtr->clientData = clientData;
+    layoutPtr->depth = depth;
+    layoutPtr->seq = tsdPtr->numLayouts++;
+}
+
+/*
+ *----------------------------------------------------------------------
+ *
+ * TkCancelLayout --
+ *
+ *	Cancels a request made with TkScheduleLayout.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	proc will not be called with clientData, neither in a later pass nor
+ *	in the passes being run.
+ *
+ *----------------------------------------------------------------------
+ */
+
+void
+TkCancelLayout(
+    Tcl_IdleProc *proc,		/* Layout function. */
+    void *clientData)		/* Argument for proc. */
+{
+    ThreadSpecificData *tsdPtr = (ThreadSpecificData *)
+	    Tcl_GetThreadData(&dataKey, sizeof(ThreadSpecificData));
+    RequestBatch *batchPtr;
+
+    CancelRequests(tsdPtr->layouts, tsdPtr->numLayouts, proc, clientData);
+    for (batchPtr = tsdPtr->layoutBatchPtr; batchPtr != NULL;
+	    batchPtr = batchPtr->nextPtr) {
+	CancelRequests(batchPtr->requests, batchPtr->numRequests, proc,
+		clientData);
+    }
+}
+
+/*
+ *----------------------------------------------------------------------
+ *
+ * LayoutIdleProc --
+ *
+ *	Run one layout pass: call the layout functions requested so far,
+ *	deepest containers first, including those requested by the layouts
+ *	run in this pass, but none of them twice.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Windows are arranged. Another pass is scheduled if requests remain.
+ *
+ *----------------------------------------------------------------------
+ */
+
+static int
+CompareLayouts(
+    const void *first,
+    const void *second)
+{
+    const PendingLayout *l1 = (const PendingLayout *)first;
+    const PendingLayout *l2 = (const PendingLayout *)second;
+
+    if (l1->depth != l2->depth) {
+	return (l1->depth > l2->depth) ? -1 : 1;
+    }
+    return (l1->seq < l2->seq) ? -1 : (l1->seq > l2->seq);
+}
+
+static void
+LayoutIdleProc(
+    void *clientData)
+{
+    ThreadSpecificData *tsdPtr = (ThreadSpecificData *)clientData;
+    Tcl_HashTable done;
+    RequestBatch batch;
+    Tcl_Size i;
+    int isNew, ranSome;
+
+    tsdPtr->layoutPending = 0;
+    Tcl_InitHashTable(&done, TCL_ONE_WORD_KEYS);
+    batch.nextPtr = tsdPtr->layoutBatchPtr;
+    tsdPtr->layoutBatchPtr = &batch;
+    do {
+	/*
+	 * Take the pending requests; those made while they run start a new
+	 * array, which the next iteration picks up.
+	 */
+
+	batch.requests = tsdPtr->layouts;
+	batch.numRequests = tsdPtr->numLayouts;
+	tsdPtr->layouts = NULL;
+	tsdPtr->numLayouts = tsdPtr->layoutSpace = 0;
+
+	ranSome = 0;
+	qsort(batch.requests, batch.numRequests, sizeof(PendingLayout),
+		CompareLayouts);
+	for (i = 0; i < batch.numRequests; i++) {
+	    Tcl_IdleProc *proc = batch.requests[i].proc;
+	    void *procData = batch.requests[i].clientData;
+
+	    if (proc == NULL) {
+		continue;
+	    }
+	    Tcl_CreateHashEntry(&done, procData, &isNew);
+	    if (!isNew) {
+		continue;
+	    }
+	    batch.requests[i].proc = NULL;
+	    proc(procData);
+	    ranSome = 1;
+	}
+
+	/*
+	 * Requests for layouts that have already run in this pass are left
+	 * for the next one.
+	 */
+
+	for (i = 0; i < batch.numRequests; i++) {
+	    if (batch.requests[i].proc != NULL) {
+		AddLayout(tsdPtr, batch.requests[i].proc,
+			batch.requests[i].clientData, batch.requests[i].depth);
+	    }
+	}
+	if (batch.requests != NULL) {
+	    ckfree(batch.requests);
+	}
+	batch.requests = NULL;
+	batch.numRequests = 0;
+    } while (ranSome && (tsdPtr->numLayouts > 0));
+    tsdPtr->layoutBatchPtr = batch.nextPtr;
+    Tcl_DeleteHashTable(&done);
+
+    if ((tsdPtr->numLayouts > 0) && !tsdPtr->layoutPending) {
+	Tcl_DoWhenIdle(LayoutIdleProc, tsdPtr);
+	tsdPtr->layoutPending = 1;
+    }
+}
+
+/*
+ *----------------------------------------------------------------------
+ *
+ * TkStatsClock --
+ *
+ *	Returns the current time for timing measurements; use it through the
+ *	TkStatsStart macro, which yields 0 when timing is disabled.
+ *
+ * Results:
+ *	The time in microseconds. Never 0.
+ *
+ * Side effects:
+ *	None.
+ *
+ *----------------------------------------------------------------------
+ */
+
+Tcl_WideInt
+TkStatsClock(void)
+{
+    Tcl_Time now;
+    Tcl_WideInt usec;
+
+    Tcl_GetTime(&now);
+    usec = (Tcl_WideInt) now.sec * 1000000 + now.usec;
+    return (usec != 0) ? usec : 1;
+}
+
+/*
+ *----------------------------------------------------------------------
+ *
+ * AddStatsEntry --
+ *
+ *	Adds the duration of one call to a timing entry.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Updates *entryPtr.
+ *
+ *----------------------------------------------------------------------
+ */
+
+static void
+AddStatsEntry(
+    StatsEntry *entryPtr,
+    Tcl_WideInt duration)
+{
+    int bucket = 0;
+
+    entryPtr->count++;
+    entryPtr->total += duration;
+    if (duration > entryPtr->max) {
+	entryPtr->max = duration;
+    }
+    while ((duration > 0) && (bucket < STATS_BUCKETS - 1)) {
+	duration >>= 1;
+	bucket++;
+    }
+    entryPtr->histogram[bucket]++;
+}
+
+/*
+ *----------------------------------------------------------------------
+ *
+ * TkStatsRecord --
+ *
+ *	Records the duration of one call in the timings of the given category
+ *	for the current thread, both in total and for the given window class.
+ *	Callers fetch the class before doing the work, since the window may
+ *	be destroyed by it.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Timing tables of the current thread are created when needed.
+ *
+ *----------------------------------------------------------------------
+ */
+
+void
+TkStatsRecord(
+    TkStatsCategory category,	/* Kind of work that was measured. */
+    Tk_Uid className,		/* Class of the window the work was done for,
+				 * or NULL. */
+    Tcl_WideInt start)		/* Result of TkStatsStart() before the
+				 * work. */
+{
+    ThreadSpecificData *tsdPtr = (ThreadSpecificData *)
+	    Tcl_GetThreadData(&dataKey, sizeof(ThreadSpecificData));
+    Tcl_WideInt duration = TkStatsClock() - start;
+    StatsCategory *catPtr;
+    StatsEntry *entryPtr;
+    Tcl_HashEntry *hPtr;
+    int i, isNew;
+
+    if (duration < 0) {
+	duration = 0;
+    }
+    if (tsdPtr->statsPtr == NULL) {
+	tsdPtr->statsPtr = (StatsCategory *)ckalloc(
+		TK_STATS_CATEGORIES * sizeof(StatsCategory));
+	for (i = 0; i < TK_STATS_CATEGORIES; i++) {
+	    memset(&tsdPtr->statsPtr[i].all, 0, sizeof(StatsEntry));
+	    Tcl_InitHashTable(&tsdPtr->statsPtr[i].classTable,
+		    TCL_ONE_WORD_KEYS);
+	}
+    }
+    catPtr = &tsdPtr->statsPtr[category];
+    AddStatsEntry(&catPtr->all, duration);
+
+    hPtr = Tcl_CreateHashEntry(&catPtr->classTable, className, &isNew);
+    if (isNew) {
+	entryPtr = (StatsEntry *)ckalloc(sizeof(StatsEntry));
+	memset(entryPtr, 0, sizeof(StatsEntry));
+	Tcl_SetHashValue(hPtr, entryPtr);
+    } else {
+	entryPtr = (StatsEntry *)Tcl_GetHashValue(hPtr);
+    }
+    AddStatsEntry(entryPtr, duration);
+}
+
+/*
+ *----------------------------------------------------------------------
+ *
+ * StatsEntryObj --
+ *
+ *	Converts a timing entry to a dictionary for "tk stats".
+ *
+ * Results:
+ *	A new dictionary with the count, total and max of the entry, and its
+ *	histogram if withHistogram is non-zero.
+ *
+ * Side effects:
+ *	None.
+ *
+ *----------------------------------------------------------------------
+ */
+
+static Tcl_Obj *
+StatsEntryObj(
+    StatsEntry *entryPtr,
+    int withHistogram)
+{
+    Tcl_Obj *resultObj = Tcl_NewDictObj();
+
+    Tcl_DictObjPut(NULL, resultObj, Tcl_NewStringObj("count", TCL_INDEX_NONE),
+	    Tcl_NewWideIntObj(entryPtr->count));
+    Tcl_DictObjPut(NULL, resultObj, Tcl_NewStringObj("total", TCL_INDEX_NONE),
+	    Tcl_NewWideIntObj(entryPtr->total));
+    Tcl_DictObjPut(NULL, resultObj, Tcl_NewStringObj("max", TCL_INDEX_NONE),
+	    Tcl_NewWideIntObj(entryPtr->max));
+    if (withHistogram) {
+	Tcl_Obj *histObj = Tcl_NewListObj(0, NULL);
+	int i;
+
+	for (i = 0; i < STATS_BUCKETS; i++) {
+	    Tcl_ListObjAppendElement(NULL, histObj,
+		    Tcl_NewWideIntObj(entryPtr->histogram[i]));
+	}
+	Tcl_DictObjPut(NULL, resultObj,
+		Tcl_NewStringObj("histogram", TCL_INDEX_NONE), histObj);
+    }
+    return resultObj;
+}
+
+/*
+ *----------------------------------------------------------------------
+ *
+ * TkStatsGetObj --
+ *
+ *	Returns the timings of the current thread for "tk stats".
+ *
+ * Results:
+ *	A dictionary with one key per category, each holding the count,
+ *	total, max and histogram of the category as a whole, and the same
+ *	values except the histogram for each window class under "classes".
+ *
+ * Side effects:
+ *	None.
+ *
+ *----------------------------------------------------------------------
+ */
+
+Tcl_Obj *
+TkStatsGetObj(void)
+{
+    static const char *const categoryNames[] = {
+	"event", "bind", "redisplay", "geometry"
+    };
+    ThreadSpecificData *tsdPtr = (ThreadSpecificData *)
+	    Tcl_GetThreadData(&dataKey, sizeof(ThreadSpecificData));
+    Tcl_Obj *resultObj = Tcl_NewDictObj();
+    StatsEntry empty;
+    int i;
+
+    memset(&empty, 0, sizeof(StatsEntry));
+    for (i = 0; i < TK_STATS_CATEGORIES; i++) {
+	Tcl_Obj *catObj, *classesObj = Tcl_NewDictObj();
+
+	if (tsdPtr->statsPtr != NULL) {
+	    StatsCategory *catPtr = &tsdPtr->statsPtr[i];
+	    Tcl_HashEntry *hPtr;
+	    Tcl_HashSearch search;
+
+	    catObj = StatsEntryObj(&catPtr->all, 1);
+	    for (hPtr = Tcl_FirstHashEntry(&catPtr->classTable, &search);
+		    hPtr != NULL; hPtr = Tcl_NextHashEntry(&search)) {
+		const char *className = (const char *)
+			Tcl_GetHashKey(&catPtr->classTable, hPtr);
+
+		Tcl_DictObjPut(NULL, classesObj, Tcl_NewStringObj(
+			(className != NULL) ? className : "", TCL_INDEX_NONE),
+			StatsEntryObj((StatsEntry *)Tcl_GetHashValue(hPtr), 0));
+	    }
+	} else {
+	    catObj = StatsEntryObj(&empty, 1);
+	}
+	Tcl_DictObjPut(NULL, catObj,
+		Tcl_NewStringObj("classes", TCL_INDEX_NONE), classesObj);
+	Tcl_DictObjPut(NULL, resultObj,
+		Tcl_NewStringObj(categoryNames[i], TCL_INDEX_NONE), catObj);
+    }
+    return resultObj;
+}
+
+/*
+ *----------------------------------------------------------------------
+ *
+ * TkStatsReset, FreeStats --
+ *
+ *	Discard the timings collected in the current thread, or in the thread
+ *	owning tsdPtr.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Memory is freed.
+ *
+ *----------------------------------------------------------------------
+ */
+
+void
+TkStatsReset(void)
+{
+    FreeStats((ThreadSpecificData *)
+	    Tcl_GetThreadData(&dataKey, sizeof(ThreadSpecificData)));
+}
+
+static void
+FreeStats(
+    ThreadSpecificData *tsdPtr)
+{
+    Tcl_HashEntry *hPtr;
+    Tcl_HashSearch search;
+    int i;
+
+    if (tsdPtr->statsPtr == NULL) {
+	return;
+    }
+    for (i = 0; i < TK_STATS_CATEGORIES; i++) {
+	Tcl_HashTable *tablePtr = &tsdPtr->statsPtr[i].classTable;
+
+	for (hPtr = Tcl_FirstHashEntry(tablePtr, &search); hPtr != NULL;
+		hPtr = Tcl_NextHashEntry(&search)) {
+	    ckfree(Tcl_GetHashValue(hPtr));
+	}
+	Tcl_DeleteHashTable(tablePtr);
     }
+    ckfree(tsdPtr->statsPtr);
+    tsdPtr->statsPtr = NULL;
 }
 
 /*
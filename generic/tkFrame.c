@@ -1487,6 +1487,29 @@ DisplayFrame(
     if (framePtr->border == NULL) {
 	return;
     }
+    Tk_GetPixelsFromObj(NULL, framePtr->tkwin, framePtr->borderWidthObj, &borderWidth);
+
+#if !defined(_WIN32) && !defined(MAC_OSX_TK)
+    /*
+     * A frame without a visible border, label or background image shows
+     * nothing but its background color, which the X server already paints
+     * from the window's background pixel. Clear the interior with a single
+     * request rather than drawing it through an off-screen pixmap: forms
+     * made of many such frames then cost no pixmaps at all.
+     */
+
+    if ((framePtr->type != TYPE_LABELFRAME) && (framePtr->bgimg == NULL)
+	    && ((borderWidth == 0) || (framePtr->relief == TK_RELIEF_FLAT))) {
+	int width = Tk_Width(tkwin) - 2 * highlightWidth;
+	int height = Tk_Height(tkwin) - 2 * highlightWidth;
+
+	if ((width > 0) && (height > 0)) {
+	    XClearArea(framePtr->display, Tk_WindowId(tkwin), highlightWidth,
+		    highlightWidth, (unsigned) width, (unsigned) height, False);
+	}
+	return;
+    }
+#endif /* !_WIN32 && !MAC_OSX_TK */
 
 #ifndef TK_NO_DOUBLE_BUFFERING
     /*
@@ -1507,7 +1530,6 @@ DisplayFrame(
     Tk_ClipDrawableToRect(Tk_Display(tkwin), pixmap, 0, 0,
 			  Tk_Width(tkwin), Tk_Height(tkwin));
 #endif /* TK_NO_DOUBLE_BUFFERING */
-    Tk_GetPixelsFromObj(NULL, framePtr->tkwin, framePtr->borderWidthObj, &borderWidth);
 
     if (framePtr->type != TYPE_LABELFRAME) {
 	/*
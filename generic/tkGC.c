@@ -17,15 +17,21 @@
  * One of the following data structures exists for each GC that is currently
  * active. The structure is indexed with two hash tables, one based on the
  * values in the graphics context and the other based on the display and GC
- * identifier.
+ * identifier. A GC whose reference count has dropped to zero may be kept in
+ * both tables for a while, on a per-display list of unused GCs ordered from
+ * the most to the least recently released.
  */
 
-typedef struct {
+typedef struct TkGC {
     GC gc;			/* Graphics context. */
     Display *display;		/* Display to which gc belongs. */
     size_t refCount;		/* Number of active uses of gc. */
     Tcl_HashEntry *valueHashPtr;/* Entry in valueTable (needed when deleting
 				 * this structure). */
+    struct TkGC *prevPtr;	/* Next more recently released unused GC, or
+				 * NULL. Only valid if refCount is 0. */
+    struct TkGC *nextPtr;	/* Next less recently released unused GC, or
+				 * NULL. Only valid if refCount is 0. */
 } TkGC;
 
 typedef struct {
@@ -35,11 +41,26 @@ typedef struct {
     int depth;			/* and depth for which GC is valid. */
 } ValueKey;
 
+/*
+ * The maximum number of unused GCs that are kept for each display. Once this
+ * many are kept, a request for a GC that does not exist yet changes the least
+ * recently released one to the new values instead of creating another.
+ */
+
+#define GC_CACHE_SIZE 32
+
 /*
  * Forward declarations for functions defined in this file:
  */
 
+static unsigned long	DiffGCValues(const XGCValues *v1,
+			    const XGCValues *v2);
+static void		FreeGC(TkDisplay *dispPtr, TkGC *gcPtr);
 static void		GCInit(TkDisplay *dispPtr);
+static TkGC *		ReuseUnusedGC(TkDisplay *dispPtr,
+			    ValueKey *valueKeyPtr,
+			    Tcl_HashEntry *valueHashPtr);
+static void		UnlinkUnusedGC(TkDisplay *dispPtr, TkGC *gcPtr);
 
 /*
  *----------------------------------------------------------------------
@@ -219,15 +240,26 @@ Tk_GetGC(
 	    (char *) &valueKey, &isNew);
     if (!isNew) {
 	gcPtr = (TkGC *)Tcl_GetHashValue(valueHashPtr);
+	if (gcPtr->refCount == 0) {
+	    UnlinkUnusedGC(dispPtr, gcPtr);
+	}
 	gcPtr->refCount++;
 	return gcPtr->gc;
     }
 
     /*
-     * No GC is currently available for this set of values. Allocate a new GC
-     * and add a new structure to the database.
+     * No GC is currently available for this set of values. If the cache of
+     * unused GCs is full, change one of them to the new values. Otherwise
+     * allocate a new GC and add a new structure to the database.
      */
 
+    if (dispPtr->gcNumUnused >= GC_CACHE_SIZE) {
+	gcPtr = ReuseUnusedGC(dispPtr, &valueKey, valueHashPtr);
+	if (gcPtr != NULL) {
+	    return gcPtr->gc;
+	}
+    }
+
     gcPtr = (TkGC *)ckalloc(sizeof(TkGC));
 
     /*
@@ -279,8 +311,9 @@ Tk_GetGC(
  *	None.
  *
  * Side effects:
- *	The reference count associated with gc is decremented, and gc is
- *	officially deallocated if no-one is using it anymore.
+ *	The reference count associated with gc is decremented. If no-one is
+ *	using gc anymore, it is either kept on the list of unused GCs for
+ *	later reuse or officially deallocated.
  *
  *----------------------------------------------------------------------
  */
@@ -292,6 +325,7 @@ Tk_FreeGC(
 {
     Tcl_HashEntry *idHashPtr;
     TkGC *gcPtr;
+    ValueKey *valueKeyPtr;
     TkDisplay *dispPtr = TkGetDisplay(display);
 
     if (!dispPtr->gcInit) {
@@ -312,12 +346,226 @@ Tk_FreeGC(
 	Tcl_Panic("Tk_FreeGC received unknown gc argument");
     }
     gcPtr = (TkGC *)Tcl_GetHashValue(idHashPtr);
-    if (gcPtr->refCount-- <= 1) {
-	XFreeGC(gcPtr->display, gcPtr->gc);
-	Tcl_DeleteHashEntry(gcPtr->valueHashPtr);
-	Tcl_DeleteHashEntry(idHashPtr);
-	ckfree(gcPtr);
+    if (gcPtr->refCount-- > 1) {
+	return;
+    }
+    gcPtr->refCount = 0;
+
+    /*
+     * A GC that refers to another server resource is freed at once: the
+     * resource may be freed, and its identifier reused, while the GC is
+     * unused.
+     */
+
+    valueKeyPtr = (ValueKey *)Tcl_GetHashKey(&dispPtr->gcValueTable,
+	    gcPtr->valueHashPtr);
+    if ((valueKeyPtr->values.tile != None)
+	    || (valueKeyPtr->values.stipple != None)
+	    || (valueKeyPtr->values.font != None)
+	    || (valueKeyPtr->values.clip_mask != None)) {
+	FreeGC(dispPtr, gcPtr);
+	return;
+    }
+
+    /*
+     * Keep the GC for reuse, evicting the least recently released one if
+     * there are too many.
+     */
+
+    gcPtr->prevPtr = NULL;
+    gcPtr->nextPtr = dispPtr->gcUnusedPtr;
+    if (dispPtr->gcUnusedPtr != NULL) {
+	dispPtr->gcUnusedPtr->prevPtr = gcPtr;
+    } else {
+	dispPtr->gcOldestPtr = gcPtr;
+    }
+    dispPtr->gcUnusedPtr = gcPtr;
+    if (++dispPtr->gcNumUnused > GC_CACHE_SIZE) {
+	gcPtr = dispPtr->gcOldestPtr;
+	UnlinkUnusedGC(dispPtr, gcPtr);
+	FreeGC(dispPtr, gcPtr);
+    }
+}
+
+/*
+ *----------------------------------------------------------------------
+ *
+ * UnlinkUnusedGC --
+ *
+ *	Removes a GC from the list of unused GCs of its display.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	The list is updated.
+ *
+ *----------------------------------------------------------------------
+ */
+
+static void
+UnlinkUnusedGC(
+    TkDisplay *dispPtr,		/* Display to which the GC belongs. */
+    TkGC *gcPtr)		/* GC to remove from the list. */
+{
+    if (gcPtr->prevPtr != NULL) {
+	gcPtr->prevPtr->nextPtr = gcPtr->nextPtr;
+    } else {
+	dispPtr->gcUnusedPtr = gcPtr->nextPtr;
+    }
+    if (gcPtr->nextPtr != NULL) {
+	gcPtr->nextPtr->prevPtr = gcPtr->prevPtr;
+    } else {
+	dispPtr->gcOldestPtr = gcPtr->prevPtr;
     }
+    dispPtr->gcNumUnused--;
+}
+
+/*
+ *----------------------------------------------------------------------
+ *
+ * FreeGC --
+ *
+ *	Deallocates a GC and removes it from the database.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	The GC is freed on the server, and gcPtr is freed.
+ *
+ *----------------------------------------------------------------------
+ */
+
+static void
+FreeGC(
+    TkDisplay *dispPtr,		/* Display to which the GC belongs. */
+    TkGC *gcPtr)		/* GC to free. It must not be on the list of
+				 * unused GCs. */
+{
+    Tcl_HashEntry *idHashPtr;
+
+    idHashPtr = Tcl_FindHashEntry(&dispPtr->gcIdTable, gcPtr->gc);
+    XFreeGC(gcPtr->display, gcPtr->gc);
+    Tcl_DeleteHashEntry(gcPtr->valueHashPtr);
+    Tcl_DeleteHashEntry(idHashPtr);
+    ckfree(gcPtr);
+}
+
+/*
+ *----------------------------------------------------------------------
+ *
+ * ReuseUnusedGC --
+ *
+ *	Looks for an unused GC for the same screen and depth as a request,
+ *	starting from the least recently released one, and changes it to the
+ *	requested values.
+ *
+ * Results:
+ *	The reused GC, which has a reference count of 1 and is registered
+ *	under valueHashPtr, or NULL if there is no suitable GC.
+ *
+ * Side effects:
+ *	The GC is removed from the list of unused GCs and its values are
+ *	changed on the server.
+ *
+ *----------------------------------------------------------------------
+ */
+
+static TkGC *
+ReuseUnusedGC(
+    TkDisplay *dispPtr,		/* Display for which the GC is requested. */
+    ValueKey *valueKeyPtr,	/* The requested values. */
+    Tcl_HashEntry *valueHashPtr)/* New entry for those values in
+				 * gcValueTable. */
+{
+    TkGC *gcPtr;
+    ValueKey *oldKeyPtr;
+    unsigned long changeMask;
+
+    for (gcPtr = dispPtr->gcOldestPtr; gcPtr != NULL;
+	    gcPtr = gcPtr->prevPtr) {
+	oldKeyPtr = (ValueKey *)Tcl_GetHashKey(&dispPtr->gcValueTable,
+		gcPtr->valueHashPtr);
+	if ((oldKeyPtr->screenNum == valueKeyPtr->screenNum)
+		&& (oldKeyPtr->depth == valueKeyPtr->depth)) {
+	    break;
+	}
+    }
+    if (gcPtr == NULL) {
+	return NULL;
+    }
+
+    /*
+     * Unused GCs never refer to other resources, so every value that differs
+     * can be set with XChangeGC.
+     */
+
+    changeMask = DiffGCValues(&oldKeyPtr->values, &valueKeyPtr->values);
+    if (changeMask != 0) {
+	XChangeGC(gcPtr->display, gcPtr->gc, changeMask,
+		&valueKeyPtr->values);
+    }
+    UnlinkUnusedGC(dispPtr, gcPtr);
+    Tcl_DeleteHashEntry(gcPtr->valueHashPtr);
+    gcPtr->valueHashPtr = valueHashPtr;
+    gcPtr->refCount = 1;
+    Tcl_SetHashValue(valueHashPtr, gcPtr);
+    return gcPtr;
+}
+
+/*
+ *----------------------------------------------------------------------
+ *
+ * DiffGCValues --
+ *
+ *	Compares two complete sets of GC values, as stored in a ValueKey.
+ *
+ * Results:
+ *	The mask of the GC components whose values differ.
+ *
+ * Side effects:
+ *	None.
+ *
+ *----------------------------------------------------------------------
+ */
+
+static unsigned long
+DiffGCValues(
+    const XGCValues *v1,
+    const XGCValues *v2)
+{
+    unsigned long mask = 0;
+
+#define DIFF(field, bit) \
+    if (v1->field != v2->field) { \
+	mask |= (bit); \
+    }
+    DIFF(function, GCFunction);
+    DIFF(plane_mask, GCPlaneMask);
+    DIFF(foreground, GCForeground);
+    DIFF(background, GCBackground);
+    DIFF(line_width, GCLineWidth);
+    DIFF(line_style, GCLineStyle);
+    DIFF(cap_style, GCCapStyle);
+    DIFF(join_style, GCJoinStyle);
+    DIFF(fill_style, GCFillStyle);
+    DIFF(fill_rule, GCFillRule);
+    DIFF(arc_mode, GCArcMode);
+    DIFF(tile, GCTile);
+    DIFF(stipple, GCStipple);
+    DIFF(ts_x_origin, GCTileStipXOrigin);
+    DIFF(ts_y_origin, GCTileStipYOrigin);
+    DIFF(font, GCFont);
+    DIFF(subwindow_mode, GCSubwindowMode);
+    DIFF(graphics_exposures, GCGraphicsExposures);
+    DIFF(clip_x_origin, GCClipXOrigin);
+    DIFF(clip_y_origin, GCClipYOrigin);
+    DIFF(clip_mask, GCClipMask);
+    DIFF(dash_offset, GCDashOffset);
+    DIFF(dashes, GCDashList);
+#undef DIFF
+    return mask;
 }
 
 /*
@@ -356,6 +604,8 @@ TkGCCleanup(
     }
     Tcl_DeleteHashTable(&dispPtr->gcValueTable);
     Tcl_DeleteHashTable(&dispPtr->gcIdTable);
+    dispPtr->gcUnusedPtr = dispPtr->gcOldestPtr = NULL;
+    dispPtr->gcNumUnused = 0;
     dispPtr->gcInit = -1;
 }
 
@@ -88,6 +88,9 @@ typedef struct SlotInfo {
 				 * introspection. It is the pixel offset of
 				 * the right or bottom edge of this slot from
 				 * the beginning of the layout. */
+    int natural;		/* The value of offset computed by the last
+				 * call to ResolveConstraints, before it was
+				 * adjusted to the size of the container. */
     int temp;			/* This is a temporary value used for
 				 * calculating adjusted weights when shrinking
 				 * the layout below its nominal size. */
@@ -144,6 +147,12 @@ typedef struct {
 				 * container. */
     Tk_Anchor anchor;		/* Value of anchor option: specifies where a
 				 * grid without weight should be placed. */
+    int resolvedColumns;	/* Number of columns when the column
+				 * constraints were last resolved. */
+    int naturalWidth;		/* Width of the layout they resolved to. */
+    int resolvedRows;		/* Number of rows when the row constraints
+				 * were last resolved. */
+    int naturalHeight;		/* Height of the layout they resolved to. */
 } GridContainer;
 
 /*
@@ -194,6 +203,9 @@ typedef struct Gridder {
 				 * is deleted. */
     int flags;			/* Miscellaneous flags; see below for
 				 * definitions. */
+    int reqWidth, reqHeight;	/* Requested size of the window when the
+				 * constraints of its container were last
+				 * resolved, or -1. */
 
     /*
      * These fields are used temporarily for layout calculations only.
@@ -243,11 +255,21 @@ typedef struct UniformGroup {
  *				needs of its content.
  * ALLOCED_CONTAINER		1 means that Grid has allocated itself as
  *				geometry container for this window.
+ * COLUMNS_RESOLVED		1 means that the natural column offsets of
+ *				this container are still valid, and need not
+ *				be computed again by ResolveConstraints.
+ * ROWS_RESOLVED		Same as COLUMNS_RESOLVED, for rows.
+ * NEEDS_MAP			1 means ArrangeGrid has placed this content
+ *				and will map it once all of its siblings have
+ *				been placed.
  */
 
 #define REQUESTED_RELAYOUT	1
 #define DONT_PROPAGATE		2
 #define ALLOCED_CONTAINER	4
+#define COLUMNS_RESOLVED	8
+#define ROWS_RESOLVED		16
+#define NEEDS_MAP		32
 
 /*
  * Prototypes for procedures used only in this file:
@@ -294,6 +316,7 @@ static void		GridReqProc(void *clientData, Tk_Window tkwin);
 static void		InitContainerData(Gridder *containerPtr);
 static Tcl_Obj *	NewPairObj(Tcl_WideInt, Tcl_WideInt);
 static Tcl_Obj *	NewQuadObj(Tcl_WideInt, Tcl_WideInt, Tcl_WideInt, Tcl_WideInt);
+static int		ResolveSlots(Gridder *containerPtr, int slotType);
 static int		ResolveConstraints(Gridder *gridPtr, int rowOrColumn,
 			    int maxOffset);
 static void		SetGridSize(Gridder *gridPtr);
@@ -487,7 +510,7 @@ GridAnchorCommand(
 	}
 	if (!(containerPtr->flags & REQUESTED_RELAYOUT)) {
 	    containerPtr->flags |= REQUESTED_RELAYOUT;
-	    Tcl_DoWhenIdle(ArrangeGrid, containerPtr);
+	    TkScheduleLayout(containerPtr->tkwin, ArrangeGrid, containerPtr);
 	}
     }
     return TCL_OK;
@@ -684,7 +707,7 @@ GridForgetRemoveCommand(
 		}
 		contentPtr->doubleBw = 2*Tk_Changes(tkwin)->border_width;
 		if (contentPtr->flags & REQUESTED_RELAYOUT) {
-		    Tcl_CancelIdleCall(ArrangeGrid, contentPtr);
+		    TkCancelLayout(ArrangeGrid, contentPtr);
 		}
 		contentPtr->flags = 0;
 		contentPtr->sticky = 0;
@@ -844,7 +867,7 @@ GridLocationCommand(
      */
 
     while (containerPtr->flags & REQUESTED_RELAYOUT) {
-	Tcl_CancelIdleCall(ArrangeGrid, containerPtr);
+	TkCancelLayout(ArrangeGrid, containerPtr);
 	ArrangeGrid(containerPtr);
     }
     SetGridSize(containerPtr);
@@ -959,7 +982,7 @@ GridPropagateCommand(
 	}
 	if (!(containerPtr->flags & REQUESTED_RELAYOUT)) {
 	    containerPtr->flags |= REQUESTED_RELAYOUT;
-	    Tcl_DoWhenIdle(ArrangeGrid, containerPtr);
+	    TkScheduleLayout(containerPtr->tkwin, ArrangeGrid, containerPtr);
 	}
     }
     return TCL_OK;
@@ -1288,9 +1311,10 @@ GridRowColumnConfigureCommand(
     if (containerPtr->abortPtr != NULL) {
 	*containerPtr->abortPtr = 1;
     }
+    containerPtr->flags &= ~(COLUMNS_RESOLVED|ROWS_RESOLVED);
     if (!(containerPtr->flags & REQUESTED_RELAYOUT)) {
 	containerPtr->flags |= REQUESTED_RELAYOUT;
-	Tcl_DoWhenIdle(ArrangeGrid, containerPtr);
+	TkScheduleLayout(containerPtr->tkwin, ArrangeGrid, containerPtr);
     }
     return TCL_OK;
 
@@ -1465,12 +1489,27 @@ GridReqProc(
     TCL_UNUSED(Tk_Window))		/* Other Tk-related information about the
 				 * window. */
 {
-    Gridder *gridPtr = (Gridder *)clientData;
+    Gridder *contentPtr = (Gridder *)clientData;
+    Gridder *gridPtr = contentPtr->containerPtr;
+
+    if (gridPtr == NULL) {
+	return;
+    }
 
-    gridPtr = gridPtr->containerPtr;
-    if (gridPtr && !(gridPtr->flags & REQUESTED_RELAYOUT)) {
+    /*
+     * Only the rows or columns along which the requested size changed need
+     * to have their constraints resolved again.
+     */
+
+    if (Tk_ReqWidth(contentPtr->tkwin) != contentPtr->reqWidth) {
+	gridPtr->flags &= ~COLUMNS_RESOLVED;
+    }
+    if (Tk_ReqHeight(contentPtr->tkwin) != contentPtr->reqHeight) {
+	gridPtr->flags &= ~ROWS_RESOLVED;
+    }
+    if (!(gridPtr->flags & REQUESTED_RELAYOUT)) {
 	gridPtr->flags |= REQUESTED_RELAYOUT;
-	Tcl_DoWhenIdle(ArrangeGrid, gridPtr);
+	TkScheduleLayout(gridPtr->tkwin, ArrangeGrid, gridPtr);
     }
 }
 
@@ -1762,6 +1801,8 @@ ArrangeGrid(
     int width, height;		/* Requested size of layout, in pixels. */
     int realWidth, realHeight;	/* Actual size layout should take-up. */
     int usedX, usedY;
+    Tcl_WideInt statsStart;
+    Tk_Uid statsClass;
 
     containerPtr->flags &= ~REQUESTED_RELAYOUT;
 
@@ -1791,14 +1832,16 @@ ArrangeGrid(
     containerPtr->abortPtr = &abort;
     abort = 0;
     Tcl_Preserve(containerPtr);
+    statsStart = TkStatsStart();
+    statsClass = Tk_Class(containerPtr->tkwin);
 
     /*
      * Call the constraint engine to fill in the row and column offsets.
      */
 
     SetGridSize(containerPtr);
-    width = ResolveConstraints(containerPtr, COLUMN, 0);
-    height = ResolveConstraints(containerPtr, ROW, 0);
+    width = ResolveSlots(containerPtr, COLUMN);
+    height = ResolveSlots(containerPtr, ROW);
     width += Tk_InternalBorderLeft(containerPtr->tkwin) +
 	    Tk_InternalBorderRight(containerPtr->tkwin);
     height += Tk_InternalBorderTop(containerPtr->tkwin) +
@@ -1817,9 +1860,12 @@ ArrangeGrid(
 	Tk_GeometryRequest(containerPtr->tkwin, width, height);
 	if (width>1 && height>1) {
 	    containerPtr->flags |= REQUESTED_RELAYOUT;
-	    Tcl_DoWhenIdle(ArrangeGrid, containerPtr);
+	    TkScheduleLayout(containerPtr->tkwin, ArrangeGrid, containerPtr);
 	}
 	containerPtr->abortPtr = NULL;
+	if (statsStart != 0) {
+	    TkStatsRecord(TK_STATS_GEOMETRY, statsClass, statsStart);
+	}
 	Tcl_Release(containerPtr);
 	return;
     }
@@ -1872,6 +1918,7 @@ ArrangeGrid(
 	 * here. Otherwise let Tk_MaintainGeometry do the work.
 	 */
 
+	contentPtr->flags &= ~NEEDS_MAP;
 	if (containerPtr->tkwin == Tk_Parent(contentPtr->tkwin)) {
 	    if ((width <= 0) || (height <= 0)) {
 		Tk_UnmapWindow(contentPtr->tkwin);
@@ -1888,11 +1935,13 @@ ArrangeGrid(
 
 		/*
 		 * Don't map the content if the container isn't mapped: wait until
-		 * the container gets mapped later.
+		 * the container gets mapped later. Otherwise defer the mapping
+		 * until all of the content has been placed.
 		 */
 
-		if (Tk_IsMapped(containerPtr->tkwin)) {
-		    Tk_MapWindow(contentPtr->tkwin);
+		if (Tk_IsMapped(containerPtr->tkwin)
+			&& !Tk_IsMapped(contentPtr->tkwin)) {
+		    contentPtr->flags |= NEEDS_MAP;
 		}
 	    }
 	} else if ((width <= 0) || (height <= 0)) {
@@ -1904,10 +1953,86 @@ ArrangeGrid(
 	}
     }
 
+    /*
+     * Map the content that was placed above in a single pass.
+     */
+
+    for (contentPtr = containerPtr->contentPtr; contentPtr != NULL && !abort;
+	    contentPtr = contentPtr->nextPtr) {
+	if (contentPtr->flags & NEEDS_MAP) {
+	    contentPtr->flags &= ~NEEDS_MAP;
+	    Tk_MapWindow(contentPtr->tkwin);
+	}
+    }
+
     containerPtr->abortPtr = NULL;
+    if (statsStart != 0) {
+	TkStatsRecord(TK_STATS_GEOMETRY, statsClass, statsStart);
+    }
     Tcl_Release(containerPtr);
 }
 
+/*
+ *----------------------------------------------------------------------
+ *
+ * ResolveSlots --
+ *
+ *	Compute the natural column or row offsets of a grid, reusing the
+ *	result of the last call to ResolveConstraints if nothing it depends on
+ *	has changed since. Relayouts caused by one content window changing its
+ *	requested width therefore need not resolve the rows again, and vice
+ *	versa.
+ *
+ * Results:
+ *	The natural size (in pixels) of the layout along that axis.
+ *
+ * Side effects:
+ *	The slot offsets are set to their natural values.
+ *
+ *----------------------------------------------------------------------
+ */
+
+static int
+ResolveSlots(
+    Gridder *containerPtr,	/* The geometry container for this grid. */
+    int slotType)		/* Either ROW or COLUMN. */
+{
+    GridContainer *gridPtr = containerPtr->containerDataPtr;
+    SlotInfo *slotPtr;
+    int flag, count, slot, size;
+    int *resolvedPtr, *naturalPtr;
+
+    if (slotType == COLUMN) {
+	flag = COLUMNS_RESOLVED;
+	slotPtr = gridPtr->columnPtr;
+	count = MAX(gridPtr->columnEnd, gridPtr->columnMax);
+	resolvedPtr = &gridPtr->resolvedColumns;
+	naturalPtr = &gridPtr->naturalWidth;
+    } else {
+	flag = ROWS_RESOLVED;
+	slotPtr = gridPtr->rowPtr;
+	count = MAX(gridPtr->rowEnd, gridPtr->rowMax);
+	resolvedPtr = &gridPtr->resolvedRows;
+	naturalPtr = &gridPtr->naturalHeight;
+    }
+
+    if ((containerPtr->flags & flag) && (*resolvedPtr == count)) {
+	for (slot = 0; slot < count; slot++) {
+	    slotPtr[slot].offset = slotPtr[slot].natural;
+	}
+	return *naturalPtr;
+    }
+
+    size = ResolveConstraints(containerPtr, slotType, 0);
+    for (slot = 0; slot < count; slot++) {
+	slotPtr[slot].natural = slotPtr[slot].offset;
+    }
+    *resolvedPtr = count;
+    *naturalPtr = size;
+    containerPtr->flags |= flag;
+    return size;
+}
+
 /*
  *----------------------------------------------------------------------
  *
@@ -2045,7 +2170,8 @@ ResolveConstraints(
 		contentPtr = contentPtr->nextPtr) {
 	    int rightEdge = contentPtr->column + contentPtr->numCols - 1;
 
-	    contentPtr->size = Tk_ReqWidth(contentPtr->tkwin) + contentPtr->padX
+	    contentPtr->reqWidth = Tk_ReqWidth(contentPtr->tkwin);
+	    contentPtr->size = contentPtr->reqWidth + contentPtr->padX
 		    + contentPtr->iPadX + contentPtr->doubleBw;
 	    if (contentPtr->numCols > 1) {
 		contentPtr->binNextPtr = layoutPtr[rightEdge].binNextPtr;
@@ -2064,7 +2190,8 @@ ResolveConstraints(
 		contentPtr = contentPtr->nextPtr) {
 	    int rightEdge = contentPtr->row + contentPtr->numRows - 1;
 
-	    contentPtr->size = Tk_ReqHeight(contentPtr->tkwin) + contentPtr->padY
+	    contentPtr->reqHeight = Tk_ReqHeight(contentPtr->tkwin);
+	    contentPtr->size = contentPtr->reqHeight + contentPtr->padY
 		    + contentPtr->iPadY + contentPtr->doubleBw;
 	    if (contentPtr->numRows > 1) {
 		contentPtr->binNextPtr = layoutPtr[rightEdge].binNextPtr;
@@ -2501,6 +2628,8 @@ GetGrid(
     gridPtr->doubleBw = 2 * Tk_Changes(tkwin)->border_width;
     gridPtr->abortPtr = NULL;
     gridPtr->flags = 0;
+    gridPtr->reqWidth = -1;
+    gridPtr->reqHeight = -1;
     gridPtr->sticky = 0;
     gridPtr->size = 0;
     gridPtr->in = NULL;
@@ -2753,6 +2882,10 @@ InitContainerData(
 	gridPtr->startX = 0;
 	gridPtr->startY = 0;
 	gridPtr->anchor = GRID_DEFAULT_ANCHOR;
+	gridPtr->resolvedColumns = -1;
+	gridPtr->naturalWidth = 0;
+	gridPtr->resolvedRows = -1;
+	gridPtr->naturalHeight = 0;
 
 	memset(gridPtr->columnPtr, 0, size);
 	memset(gridPtr->rowPtr, 0, size);
@@ -2800,9 +2933,10 @@ Unlink(
 	    }
 	}
     }
+    containerPtr->flags &= ~(COLUMNS_RESOLVED|ROWS_RESOLVED);
     if (!(containerPtr->flags & REQUESTED_RELAYOUT)) {
 	containerPtr->flags |= REQUESTED_RELAYOUT;
-	Tcl_DoWhenIdle(ArrangeGrid, containerPtr);
+	TkScheduleLayout(containerPtr->tkwin, ArrangeGrid, containerPtr);
     }
     if (containerPtr->abortPtr != NULL) {
 	*containerPtr->abortPtr = 1;
@@ -2853,7 +2987,7 @@ DestroyGrid(
     Gridder *gridPtr = (Gridder *)memPtr;
 
     if (gridPtr->flags & REQUESTED_RELAYOUT) {
-	Tcl_CancelIdleCall(ArrangeGrid, gridPtr);
+	TkCancelLayout(ArrangeGrid, gridPtr);
     }
     if (gridPtr->containerDataPtr != NULL) {
 	if (gridPtr->containerDataPtr->rowPtr != NULL) {
@@ -2901,14 +3035,16 @@ GridStructureProc(
 	if ((gridPtr->contentPtr != NULL)
 		&& !(gridPtr->flags & REQUESTED_RELAYOUT)) {
 	    gridPtr->flags |= REQUESTED_RELAYOUT;
-	    Tcl_DoWhenIdle(ArrangeGrid, gridPtr);
+	    TkScheduleLayout(gridPtr->tkwin, ArrangeGrid, gridPtr);
 	}
 	if ((gridPtr->containerPtr != NULL) &&
 		(gridPtr->doubleBw != 2*Tk_Changes(gridPtr->tkwin)->border_width)) {
+	    gridPtr->containerPtr->flags &= ~(COLUMNS_RESOLVED|ROWS_RESOLVED);
 	    if (!(gridPtr->containerPtr->flags & REQUESTED_RELAYOUT)) {
 		gridPtr->doubleBw = 2*Tk_Changes(gridPtr->tkwin)->border_width;
 		gridPtr->containerPtr->flags |= REQUESTED_RELAYOUT;
-		Tcl_DoWhenIdle(ArrangeGrid, gridPtr->containerPtr);
+		TkScheduleLayout(gridPtr->containerPtr->tkwin, ArrangeGrid,
+		    gridPtr->containerPtr);
 	    }
 	}
     } else if (eventPtr->type == DestroyNotify) {
@@ -2928,7 +3064,7 @@ GridStructureProc(
 	Tcl_DeleteHashEntry(Tcl_FindHashEntry(&dispPtr->gridHashTable,
 		gridPtr->tkwin));
 	if (gridPtr->flags & REQUESTED_RELAYOUT) {
-	    Tcl_CancelIdleCall(ArrangeGrid, gridPtr);
+	    TkCancelLayout(ArrangeGrid, gridPtr);
 	}
 	gridPtr->tkwin = NULL;
 	Tcl_EventuallyFree(gridPtr, DestroyGrid);
@@ -2936,7 +3072,7 @@ GridStructureProc(
 	if ((gridPtr->contentPtr != NULL)
 		&& !(gridPtr->flags & REQUESTED_RELAYOUT)) {
 	    gridPtr->flags |= REQUESTED_RELAYOUT;
-	    Tcl_DoWhenIdle(ArrangeGrid, gridPtr);
+	    TkScheduleLayout(gridPtr->tkwin, ArrangeGrid, gridPtr);
 	}
     } else if (eventPtr->type == UnmapNotify) {
 	Gridder *contentPtr;
@@ -3470,9 +3606,10 @@ ConfigureContent(
 	if (containerPtr->abortPtr != NULL) {
 	    *containerPtr->abortPtr = 1;
 	}
+	containerPtr->flags &= ~(COLUMNS_RESOLVED|ROWS_RESOLVED);
 	if (!(containerPtr->flags & REQUESTED_RELAYOUT)) {
 	    containerPtr->flags |= REQUESTED_RELAYOUT;
-	    Tcl_DoWhenIdle(ArrangeGrid, containerPtr);
+	    TkScheduleLayout(containerPtr->tkwin, ArrangeGrid, containerPtr);
 	}
     }
 
@@ -375,6 +375,11 @@ typedef struct TkDisplay {
     Tcl_HashTable gcIdTable;    /* Maps from a GC to a TkGC. */
     int gcInit;			/* 0 means the tables below need
 				 * initializing. */
+    struct TkGC *gcUnusedPtr;	/* Most recently released of the GCs that
+				 * are no longer in use but are kept for
+				 * reuse, or NULL. */
+    struct TkGC *gcOldestPtr;	/* Least recently released of those GCs. */
+    int gcNumUnused;		/* Number of GCs in that list. */
 
     /*
      * Information used by tkGeometry.c only:
@@ -572,6 +577,9 @@ typedef struct TkDisplay {
     int iconDataSize;		/* Size of default iconphoto image data. */
     unsigned char *iconDataPtr;	/* Default iconphoto image data, if set. */
     int ximGeneration;          /* Used to invalidate XIC */
+    int coalesceMask;		/* Event types which are coalesced while
+				 * draining the X event queue, an OR'ed
+				 * combination of the TK_COALESCE_* bits. */
 } TkDisplay;
 
 /*
@@ -582,11 +590,45 @@ typedef struct TkDisplay {
  *	Whether to use input methods for this display
  *  TK_DISPLAY_WM_TRACING:		(default off)
  *	Whether we should do wm tracing on this display.
+ *  TK_DISPLAY_COALESCE_WINDOWS:	(default off)
+ *	Set once some window on this display got its own coalescing policy,
+ *	so the policy must be looked up per window.
  */
 
 #define TK_DISPLAY_COLLAPSE_MOTION_EVENTS	(1 << 0)
 #define TK_DISPLAY_USE_IM			(1 << 1)
 #define TK_DISPLAY_WM_TRACING			(1 << 3)
+#define TK_DISPLAY_COALESCE_WINDOWS		(1 << 4)
+
+/*
+ * Event types which may be coalesced while draining the X event queue, see
+ * the "tk coalesce" command. A superseded Motion or ConfigureNotify event is
+ * dropped, the area of a superseded Expose event is merged into the later
+ * one, and consecutive mouse wheel clicks are summed into one MouseWheel
+ * event.
+ */
+
+#define TK_COALESCE_MOTION			(1 << 0)
+#define TK_COALESCE_CONFIGURE			(1 << 1)
+#define TK_COALESCE_EXPOSE			(1 << 2)
+#define TK_COALESCE_WHEEL			(1 << 3)
+
+/*
+ * Kinds of work timed for the "tk stats" command. Timing costs two clock
+ * reads per measured call, so it is only done while tkStatsEnabled is set;
+ * otherwise TkStatsStart() is a single test and TkStatsRecord is never
+ * called.
+ */
+
+typedef enum {
+    TK_STATS_EVENT,		/* Tk_HandleEvent, including bindings. */
+    TK_STATS_BIND,		/* Evaluation of binding scripts. */
+    TK_STATS_REDISPLAY,		/* Idle redisplay of widgets. */
+    TK_STATS_GEOMETRY,		/* Arranging content by geometry managers. */
+    TK_STATS_CATEGORIES		/* Number of categories; must be last. */
+} TkStatsCategory;
+
+#define TkStatsStart() (tkStatsEnabled ? TkStatsClock() : 0)
 
 /*
  * One of the following structures exists for each error handler created by a
@@ -884,6 +926,9 @@ typedef struct TkWindow {
 				/* The geometry container for this window. The
 				 * value is NULL if the window has no container or
 				 * if its container is its parent. */
+    int coalesceMask;		/* Event coalescing policy for this window
+				 * (TK_COALESCE_* bits), or -1 to use the
+				 * policy of its display. */
 } TkWindow;
 
 /*
@@ -1264,6 +1309,22 @@ MODULE_SCOPE Tcl_Command TkMakeEnsemble(Tcl_Interp *interp,
 			    const char *nsname, const char *name,
 			    void *clientData, const TkEnsemble *map);
 MODULE_SCOPE double	TkScalingLevel(Tk_Window tkwin);
+MODULE_SCOPE TkRegion	TkAccumulateExpose(TkRegion *regionPtr,
+			    XEvent *eventPtr);
+MODULE_SCOPE int	tkStatsEnabled;
+MODULE_SCOPE Tcl_WideInt TkStatsClock(void);
+MODULE_SCOPE void	TkStatsRecord(TkStatsCategory category,
+			    Tk_Uid className, Tcl_WideInt start);
+MODULE_SCOPE Tcl_Obj *	TkStatsGetObj(void);
+MODULE_SCOPE void	TkStatsReset(void);
+MODULE_SCOPE void	TkScheduleRedraw(Tk_Window tkwin, Tcl_IdleProc *proc,
+			    void *clientData);
+MODULE_SCOPE void	TkCancelRedraw(Tcl_IdleProc *proc, void *clientData);
+MODULE_SCOPE void	TkScheduleLayout(Tk_Window tkwin, Tcl_IdleProc *proc,
+			    void *clientData);
+MODULE_SCOPE void	TkCancelLayout(Tcl_IdleProc *proc, void *clientData);
+MODULE_SCOPE void	TkSetFrameRate(int rate);
+MODULE_SCOPE int	TkGetFrameRate(void);
 MODULE_SCOPE int	TkObjIsEmpty(Tcl_Obj *objPtr);
 MODULE_SCOPE int	TkInitTkCmd(Tcl_Interp *interp,
 			    void *clientData);
@@ -1282,6 +1343,7 @@ MODULE_SCOPE int TkGetIntForIndex(Tcl_Obj *, Tcl_Size, int lastOK, Tcl_Size*);
 #define TK_OPTION_UNDERLINE_DEF(type, field) NULL, TCL_INDEX_NONE, offsetof(type, field), TK_OPTION_NULL_OK, NULL
 
 
+MODULE_SCOPE int	TkParseColorName(const char *spec, XColor *colorPtr);
 #ifdef _WIN32
 #define TkParseColor XParseColor
 #else
@@ -1310,6 +1372,7 @@ MODULE_SCOPE Status TkParseColor (Display * display,
 #define TkSetRegion XSetRegion
 #define TkSubtractRegion XSubtractRegion
 #define TkUnionRectWithRegion XUnionRectWithRegion
+#define TkUnionRegion XUnionRegion
 
 #ifdef HAVE_XFT
 MODULE_SCOPE void	TkUnixSetXftClipRegion(Region clipRegion);
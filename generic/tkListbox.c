@@ -1870,6 +1870,7 @@ DisplayListbox(
     Pixmap pixmap;
     int textWidth;
     int borderWidth, selBorderWidth, highlightWidth;
+    Tcl_WideInt statsStart;
 
     listPtr->flags &= ~REDRAW_PENDING;
     if (listPtr->flags & LISTBOX_DELETED) {
@@ -1899,6 +1900,7 @@ DisplayListbox(
     }
     listPtr->flags &= ~(REDRAW_PENDING|UPDATE_V_SCROLLBAR|UPDATE_H_SCROLLBAR);
     Tcl_Release(listPtr);
+    statsStart = TkStatsStart();
 
 #ifndef TK_NO_DOUBLE_BUFFERING
     /*
@@ -2181,6 +2183,9 @@ DisplayListbox(
 	    (unsigned) Tk_Width(tkwin), (unsigned) Tk_Height(tkwin), 0, 0);
     Tk_FreePixmap(disp, pixmap);
 #endif /* TK_NO_DOUBLE_BUFFERING */
+    if (statsStart != 0) {
+	TkStatsRecord(TK_STATS_REDISPLAY, Tk_Class(tkwin), statsStart);
+    }
 }
 
 /*
@@ -2611,7 +2616,7 @@ ListboxEventProc(
 		Tk_UnsetGrid(listPtr->tkwin);
 	    }
 	    if (listPtr->flags & REDRAW_PENDING) {
-		Tcl_CancelIdleCall(DisplayListbox, clientData);
+		TkCancelRedraw(DisplayListbox, clientData);
 	    }
 	    Tcl_EventuallyFree(clientData, DestroyListbox);
 	}
@@ -3252,7 +3257,7 @@ EventuallyRedrawRange(
 	return;
     }
     listPtr->flags |= REDRAW_PENDING;
-    Tcl_DoWhenIdle(DisplayListbox, listPtr);
+    TkScheduleRedraw(listPtr->tkwin, DisplayListbox, listPtr);
 }
 
 /*
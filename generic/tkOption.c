@@ -204,9 +204,53 @@ typedef struct {
 				 * priority level. */
     Element defaultMatch;	/* Special "no match" Element to use as
 				 * default for searches.*/
+    Tcl_HashTable lookupCache;	/* Results of earlier Tk_GetOption calls.
+				 * Maps the name and class path of a window's
+				 * parent to a LookupTable, so that siblings
+				 * share an entry. Flushed whenever an option
+				 * database changes. */
+    TkWindow *lookupWindow;	/* Window whose parent's entry in lookupCache
+				 * is lookupTablePtr, or NULL. */
+    struct LookupTable *lookupTablePtr;
+				/* Lookup results for lookupWindow. */
+    Tk_Uid lookupLeafName;	/* Name of lookupWindow, or NULL if no
+				 * database entry refers to that name. */
 } ThreadSpecificData;
 static Tcl_ThreadDataKey dataKey;
 
+/*
+ * Key of the results in a LookupTable.
+ */
+
+typedef struct {
+    Tk_Uid nameUid;		/* Name of the option. */
+    Tk_Uid classUid;		/* Class of the option, or NULL. */
+    Tk_Uid leafNameUid;		/* Name of the queried window, or NULL if no
+				 * database entry refers to that name. */
+    Tk_Uid leafClassUid;	/* Class of the queried window. */
+} LookupKey;
+
+/*
+ * Remembered lookup results for the children of one name and class path.
+ * Most children have names that the option database never mentions, so
+ * their results depend only on their class and are shared between them.
+ */
+
+typedef struct LookupTable {
+    Tcl_HashTable leafNames;	/* Maps the name Uid of a child to non-zero
+				 * if some database entry below the path
+				 * refers to that name. */
+    Tcl_HashTable values;	/* Maps LookupKey structures to Tk_Uid
+				 * values. */
+} LookupTable;
+
+/*
+ * Maximum number of distinct window paths kept in the lookup cache before it
+ * is flushed.
+ */
+
+#define LOOKUP_CACHE_SIZE 1000
+
 /*
  * Forward declarations for functions defined in this file:
  */
@@ -216,6 +260,10 @@ static int		AddFromString(Tcl_Interp *interp, Tk_Window tkwin,
 static void		ClearOptionTree(ElArray *arrayPtr);
 static ElArray *	ExtendArray(ElArray *arrayPtr, Element *elPtr);
 static void		ExtendStacks(ElArray *arrayPtr, int leaf);
+static void		FlushLookupCache(ThreadSpecificData *tsdPtr);
+static LookupTable *	GetLookupTable(ThreadSpecificData *tsdPtr,
+			    TkWindow *winPtr, Tk_Uid *leafNamePtr);
+static void		AppendPathKey(TkWindow *winPtr, Tcl_DString *dsPtr);
 static int		GetDefaultOptions(Tcl_Interp *interp,
 			    TkWindow *winPtr);
 static ElArray *	NewArray(int numEls);
@@ -270,6 +318,7 @@ Tk_AddOption(
 	OptionInit(winPtr->mainPtr);
     }
     tsdPtr->cachedWindow = NULL;/* Invalidate the cache. */
+    FlushLookupCache(tsdPtr);
 
     /*
      * Compute the priority for the new element, including both the overall
@@ -391,7 +440,10 @@ Tk_AddOption(
  * Side effects:
  *	The internal caches used to speed up option mapping may be modified,
  *	if this tkwin is different from the last tkwin used for option
- *	retrieval.
+ *	retrieval. The result is remembered, so that the same query for any
+ *	sibling of the same class whose name the database doesn't mention,
+ *	or for any window with the same name and class path, needs no search
+ *	until the option database changes.
  *
  *--------------------------------------------------------------
  */
@@ -408,19 +460,46 @@ Tk_GetOption(
     Tk_Uid nameId, classId = NULL;
     const char *masqName;
     Element *elPtr, *bestPtr;
-    int count;
+    int count, isNew;
     StackLevel *levelPtr;
     int stackDepth[NUM_STACKS];
+    LookupKey key;
+    Tcl_HashEntry *cacheEntryPtr;
+    TkWindow *winPtr = (TkWindow *) tkwin;
     ThreadSpecificData *tsdPtr = (ThreadSpecificData *)
 	    Tcl_GetThreadData(&dataKey, sizeof(ThreadSpecificData));
 
+    if (winPtr->mainPtr->optionRootPtr == NULL) {
+	OptionInit(winPtr->mainPtr);
+    }
+
     /*
-     * Note: no need to call OptionInit here: it will be done by the
-     * SetupStacks call below (squeeze out those nanoseconds).
+     * See whether this query has been answered before for an equivalent
+     * window: one of the same class, with the same parent name and class
+     * path, and either the same name or a name that no database entry
+     * refers to. Widget creation queries the same options for many windows,
+     * in many parents, so this avoids rebuilding the stacks every time the
+     * queried window changes.
      */
 
+    if (winPtr != tsdPtr->lookupWindow) {
+	tsdPtr->lookupTablePtr = GetLookupTable(tsdPtr, winPtr,
+		&tsdPtr->lookupLeafName);
+	tsdPtr->lookupWindow = winPtr;
+    }
+    memset(&key, 0, sizeof(key));
+    key.nameUid = Tk_GetUid(name);
+    key.classUid = (className != NULL) ? Tk_GetUid(className) : NULL;
+    key.leafNameUid = tsdPtr->lookupLeafName;
+    key.leafClassUid = winPtr->classUid;
+    cacheEntryPtr = Tcl_CreateHashEntry(&tsdPtr->lookupTablePtr->values,
+	    (char *) &key, &isNew);
+    if (!isNew) {
+	return (Tk_Uid) Tcl_GetHashValue(cacheEntryPtr);
+    }
+
     if (tkwin != (Tk_Window) tsdPtr->cachedWindow) {
-	SetupStacks((TkWindow *) tkwin, 1);
+	SetupStacks(winPtr, 1);
     }
 
     /*
@@ -464,7 +543,7 @@ Tk_GetOption(
 	 * stack depths.
 	 */
 
-	nameId = Tk_GetUid(name);
+	nameId = key.nameUid;
 	for (count = 0; count < NUM_STACKS; count++) {
 	    stackDepth[count] = tsdPtr->stacks[count]->numUsed;
 	}
@@ -492,7 +571,7 @@ Tk_GetOption(
     }
 
     if (className != NULL) {
-	classId = Tk_GetUid(className);
+	classId = key.classUid;
 	for (elPtr = tsdPtr->stacks[EXACT_LEAF_CLASS]->els,
 		count = stackDepth[EXACT_LEAF_CLASS]; count > 0;
 		elPtr++, count--) {
@@ -588,8 +667,179 @@ Tk_GetOption(
 	}
     }
 
+    Tcl_SetHashValue(cacheEntryPtr, (void *) bestPtr->child.valueUid);
     return bestPtr->child.valueUid;
 }
+
+/*
+ *--------------------------------------------------------------
+ *
+ * GetLookupTable --
+ *
+ *	Find the table of remembered Tk_GetOption results for a window. The
+ *	result of a query depends only on the option database of the window's
+ *	application, on the names and classes of the window's ancestors, and
+ *	on the class of the window; its name matters only if some database
+ *	entry below its parent's path refers to it. The table is therefore
+ *	shared by all children of parents with the same name and class path.
+ *
+ * Results:
+ *	The return value is the LookupTable for the window's parent path.
+ *	*leafNamePtr is set to the name of the window, or to NULL if no
+ *	database entry refers to that name, for use in the lookup key.
+ *
+ * Side effects:
+ *	A new, empty table may be added to the lookup cache. The cache is
+ *	flushed if it holds too many tables. The option stacks may be set up
+ *	for the window, to find out whether its name matters.
+ *
+ *--------------------------------------------------------------
+ */
+
+static LookupTable *
+GetLookupTable(
+    ThreadSpecificData *tsdPtr,
+    TkWindow *winPtr,		/* Window being queried. */
+    Tk_Uid *leafNamePtr)	/* Where to store the name to use in lookup
+				 * keys for the window. */
+{
+    Tcl_DString pathKey;
+    Tcl_HashEntry *hPtr;
+    LookupTable *tablePtr;
+    char buf[TCL_INTEGER_SPACE + 4];
+    int isNew;
+
+    Tcl_DStringInit(&pathKey);
+    snprintf(buf, sizeof(buf), "%p", (void *) winPtr->mainPtr);
+    Tcl_DStringAppend(&pathKey, buf, TCL_INDEX_NONE);
+    if (winPtr->parentPtr != NULL) {
+	AppendPathKey(winPtr->parentPtr, &pathKey);
+    }
+
+    if (tsdPtr->lookupCache.numEntries >= LOOKUP_CACHE_SIZE) {
+	FlushLookupCache(tsdPtr);
+    }
+    hPtr = Tcl_CreateHashEntry(&tsdPtr->lookupCache,
+	    Tcl_DStringValue(&pathKey), &isNew);
+    Tcl_DStringFree(&pathKey);
+    if (isNew) {
+	tablePtr = (LookupTable *)ckalloc(sizeof(LookupTable));
+	Tcl_InitHashTable(&tablePtr->leafNames, TCL_ONE_WORD_KEYS);
+	Tcl_InitHashTable(&tablePtr->values, sizeof(LookupKey) / sizeof(int));
+	Tcl_SetHashValue(hPtr, tablePtr);
+    } else {
+	tablePtr = (LookupTable *)Tcl_GetHashValue(hPtr);
+    }
+
+    /*
+     * The window's name is only looked for in the node stacks of its parent
+     * level (see step 5 of SetupStacks); check there once per name.
+     */
+
+    hPtr = Tcl_CreateHashEntry(&tablePtr->leafNames, winPtr->nameUid,
+	    &isNew);
+    if (isNew) {
+	StackLevel *levelPtr;
+	Element *elPtr;
+	int count, found = 0;
+
+	if (winPtr != tsdPtr->cachedWindow) {
+	    SetupStacks(winPtr, 1);
+	}
+	levelPtr = &tsdPtr->levels[tsdPtr->curLevel];
+	elPtr = tsdPtr->stacks[EXACT_NODE_NAME]->els
+		+ levelPtr[-1].bases[EXACT_NODE_NAME];
+	count = levelPtr->bases[EXACT_NODE_NAME]
+		- levelPtr[-1].bases[EXACT_NODE_NAME];
+	for ( ; !found && count > 0; elPtr++, count--) {
+	    found = (elPtr->nameUid == winPtr->nameUid);
+	}
+	elPtr = tsdPtr->stacks[WILDCARD_NODE_NAME]->els;
+	count = levelPtr->bases[WILDCARD_NODE_NAME];
+	for ( ; !found && count > 0; elPtr++, count--) {
+	    found = (elPtr->nameUid == winPtr->nameUid);
+	}
+	Tcl_SetHashValue(hPtr, INT2PTR(found));
+    }
+    *leafNamePtr = PTR2INT(Tcl_GetHashValue(hPtr)) ? winPtr->nameUid : NULL;
+    return tablePtr;
+}
+
+/*
+ *--------------------------------------------------------------
+ *
+ * AppendPathKey --
+ *
+ *	Append the names and classes of a window and all of its ancestors,
+ *	outermost first, to a string.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	The string in dsPtr is extended.
+ *
+ *--------------------------------------------------------------
+ */
+
+static void
+AppendPathKey(
+    TkWindow *winPtr,		/* Innermost window of the path. */
+    Tcl_DString *dsPtr)		/* String to append to. */
+{
+    if (winPtr->parentPtr != NULL) {
+	AppendPathKey(winPtr->parentPtr, dsPtr);
+    }
+    Tcl_DStringAppend(dsPtr, "\n", 1);
+    if (winPtr->nameUid != NULL) {
+	Tcl_DStringAppend(dsPtr, winPtr->nameUid, TCL_INDEX_NONE);
+    }
+    Tcl_DStringAppend(dsPtr, "\n", 1);
+    if (winPtr->classUid != NULL) {
+	Tcl_DStringAppend(dsPtr, winPtr->classUid, TCL_INDEX_NONE);
+    }
+}
+
+/*
+ *--------------------------------------------------------------
+ *
+ * FlushLookupCache --
+ *
+ *	Forget all remembered Tk_GetOption results. Called whenever an option
+ *	database changes.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	The lookup cache is emptied.
+ *
+ *--------------------------------------------------------------
+ */
+
+static void
+FlushLookupCache(
+    ThreadSpecificData *tsdPtr)
+{
+    Tcl_HashEntry *hPtr;
+    Tcl_HashSearch search;
+    LookupTable *tablePtr;
+
+    if (!tsdPtr->initialized) {
+	return;
+    }
+    for (hPtr = Tcl_FirstHashEntry(&tsdPtr->lookupCache, &search);
+	    hPtr != NULL; hPtr = Tcl_NextHashEntry(&search)) {
+	tablePtr = (LookupTable *)Tcl_GetHashValue(hPtr);
+	Tcl_DeleteHashTable(&tablePtr->leafNames);
+	Tcl_DeleteHashTable(&tablePtr->values);
+	ckfree(tablePtr);
+    }
+    Tcl_DeleteHashTable(&tsdPtr->lookupCache);
+    Tcl_InitHashTable(&tsdPtr->lookupCache, TCL_STRING_KEYS);
+    tsdPtr->lookupWindow = NULL;
+    tsdPtr->lookupTablePtr = NULL;
+}
 
 /*
  *--------------------------------------------------------------
@@ -672,6 +922,7 @@ Tk_OptionObjCmd(
 	    mainPtr->optionRootPtr = NULL;
 	}
 	tsdPtr->cachedWindow = NULL;
+	FlushLookupCache(tsdPtr);
 	break;
     }
 
@@ -760,6 +1011,9 @@ TkOptionDeadWindow(
 	tsdPtr->curLevel = -1;
 	tsdPtr->cachedWindow = NULL;
     }
+    if (tsdPtr->lookupWindow == winPtr) {
+	tsdPtr->lookupWindow = NULL;
+    }
 
     /*
      * If this window was a main window, then delete its option database.
@@ -769,6 +1023,7 @@ TkOptionDeadWindow(
 	    && (winPtr->mainPtr->optionRootPtr != NULL)) {
 	ClearOptionTree(winPtr->mainPtr->optionRootPtr);
 	winPtr->mainPtr->optionRootPtr = NULL;
+	FlushLookupCache(tsdPtr);
     }
 }
 
@@ -799,6 +1054,13 @@ TkOptionClassChanged(
     ThreadSpecificData *tsdPtr = (ThreadSpecificData *)
 	    Tcl_GetThreadData(&dataKey, sizeof(ThreadSpecificData));
 
+    /*
+     * The class path of the window, and of any of its descendants, is now
+     * different; look up their lookup cache entries afresh.
+     */
+
+    tsdPtr->lookupWindow = NULL;
+
     if (winPtr->optionLevel < 0) {
 	return;
     }
@@ -1432,6 +1694,8 @@ OptionThreadExitProc(
 	    ckfree(tsdPtr->stacks[i]);
 	}
 	ckfree(tsdPtr->levels);
+	FlushLookupCache(tsdPtr);
+	Tcl_DeleteHashTable(&tsdPtr->lookupCache);
 	tsdPtr->initialized = 0;
     }
 }
@@ -1485,6 +1749,10 @@ OptionInit(
 	defaultMatchPtr->child.valueUid = NULL;
 	defaultMatchPtr->priority = -1;
 	defaultMatchPtr->flags = 0;
+	Tcl_InitHashTable(&tsdPtr->lookupCache, TCL_STRING_KEYS);
+	tsdPtr->lookupWindow = NULL;
+	tsdPtr->lookupTablePtr = NULL;
+	tsdPtr->lookupLeafName = NULL;
 	Tcl_CreateThreadExitHandler(OptionThreadExitProc, NULL);
     }
 
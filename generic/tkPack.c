@@ -89,6 +89,9 @@ typedef struct Packer {
  *				needs of its content.
  * ALLOCED_CONTAINER	1 means that Pack has allocated itself as
  *				geometry container for this window.
+ * NEEDS_MAP:			1 means ArrangePacking has placed this
+ *				content and will map it once all of its
+ *				siblings have been placed.
  */
 
 #define REQUESTED_REPACK	1
@@ -98,6 +101,7 @@ typedef struct Packer {
 #define OLD_STYLE		16
 #define DONT_PROPAGATE		32
 #define ALLOCED_CONTAINER	64
+#define NEEDS_MAP		128
 
 /*
  * The following structure is the official type record for the packer:
@@ -363,7 +367,8 @@ Tk_PackObjCmd(
 	    }
 	    if (!(containerPtr->flags & REQUESTED_REPACK)) {
 		containerPtr->flags |= REQUESTED_REPACK;
-		Tcl_DoWhenIdle(ArrangePacking, containerPtr);
+		TkScheduleLayout(containerPtr->tkwin, ArrangePacking,
+		    containerPtr);
 	    }
 	} else {
 	    if (containerPtr->flags & ALLOCED_CONTAINER) {
@@ -434,7 +439,7 @@ PackReqProc(
     packPtr = packPtr->containerPtr;
     if (!(packPtr->flags & REQUESTED_REPACK)) {
 	packPtr->flags |= REQUESTED_REPACK;
-	Tcl_DoWhenIdle(ArrangePacking, packPtr);
+	TkScheduleLayout(packPtr->tkwin, ArrangePacking, packPtr);
     }
 }
 
@@ -511,6 +516,8 @@ ArrangePacking(
     int borderTop, borderBtm;
     int borderLeft, borderRight;
     int maxWidth, maxHeight, tmp;
+    Tcl_WideInt statsStart;
+    Tk_Uid statsClass;
 
     containerPtr->flags &= ~REQUESTED_REPACK;
 
@@ -536,6 +543,8 @@ ArrangePacking(
     containerPtr->abortPtr = &abort;
     abort = 0;
     Tcl_Preserve(containerPtr);
+    statsStart = TkStatsStart();
+    statsClass = Tk_Class(containerPtr->tkwin);
 
     /*
      * Pass #1: scan all the content to figure out the total amount of space
@@ -604,7 +613,7 @@ ArrangePacking(
 	    && !(containerPtr->flags & DONT_PROPAGATE)) {
 	Tk_GeometryRequest(containerPtr->tkwin, maxWidth, maxHeight);
 	containerPtr->flags |= REQUESTED_REPACK;
-	Tcl_DoWhenIdle(ArrangePacking, containerPtr);
+	TkScheduleLayout(containerPtr->tkwin, ArrangePacking, containerPtr);
 	goto done;
     }
 
@@ -747,6 +756,7 @@ ArrangePacking(
 	 * this here. Otherwise let Tk_MaintainGeometry do the work.
 	 */
 
+	contentPtr->flags &= ~NEEDS_MAP;
 	if (containerPtr->tkwin == Tk_Parent(contentPtr->tkwin)) {
 	    if ((width <= 0) || (height <= 0)) {
 		Tk_UnmapWindow(contentPtr->tkwin);
@@ -763,11 +773,15 @@ ArrangePacking(
 
 		/*
 		 * Don't map the content if the container isn't mapped: wait until
-		 * the container gets mapped later.
+		 * the container gets mapped later. Otherwise defer the mapping
+		 * until all of the content has been placed, so that no window
+		 * is shown, and none is created, before its final geometry is
+		 * known.
 		 */
 
-		if (Tk_IsMapped(containerPtr->tkwin)) {
-		    Tk_MapWindow(contentPtr->tkwin);
+		if (Tk_IsMapped(containerPtr->tkwin)
+			&& !Tk_IsMapped(contentPtr->tkwin)) {
+		    contentPtr->flags |= NEEDS_MAP;
 		}
 	    }
 	} else {
@@ -791,8 +805,26 @@ ArrangePacking(
 	}
     }
 
+    /*
+     * Map the content that was placed above in a single pass.
+     */
+
+    for (contentPtr = containerPtr->contentPtr; contentPtr != NULL;
+	    contentPtr = contentPtr->nextPtr) {
+	if (contentPtr->flags & NEEDS_MAP) {
+	    contentPtr->flags &= ~NEEDS_MAP;
+	    Tk_MapWindow(contentPtr->tkwin);
+	    if (abort) {
+		goto done;
+	    }
+	}
+    }
+
   done:
     containerPtr->abortPtr = NULL;
+    if (statsStart != 0) {
+	TkStatsRecord(TK_STATS_GEOMETRY, statsClass, statsStart);
+    }
     Tcl_Release(containerPtr);
 }
 
@@ -1030,7 +1062,7 @@ Unlink(
     }
     if (!(containerPtr->flags & REQUESTED_REPACK)) {
 	containerPtr->flags |= REQUESTED_REPACK;
-	Tcl_DoWhenIdle(ArrangePacking, containerPtr);
+	TkScheduleLayout(containerPtr->tkwin, ArrangePacking, containerPtr);
     }
     if (containerPtr->abortPtr != NULL) {
 	*containerPtr->abortPtr = 1;
@@ -1079,7 +1111,7 @@ DestroyPacker(
     Packer *packPtr = (Packer *)memPtr;
 
     if (packPtr->flags & REQUESTED_REPACK) {
-	Tcl_CancelIdleCall(ArrangePacking, packPtr);
+	TkCancelLayout(ArrangePacking, packPtr);
     }
     ckfree(packPtr);
 }
@@ -1114,14 +1146,15 @@ PackStructureProc(
 	if ((packPtr->contentPtr != NULL)
 		&& !(packPtr->flags & REQUESTED_REPACK)) {
 	    packPtr->flags |= REQUESTED_REPACK;
-	    Tcl_DoWhenIdle(ArrangePacking, packPtr);
+	    TkScheduleLayout(packPtr->tkwin, ArrangePacking, packPtr);
 	}
 	if ((packPtr->containerPtr != NULL)
 		&& (packPtr->doubleBw != 2*Tk_Changes(packPtr->tkwin)->border_width)) {
 	    if (!(packPtr->containerPtr->flags & REQUESTED_REPACK)) {
 		packPtr->doubleBw = 2*Tk_Changes(packPtr->tkwin)->border_width;
 		packPtr->containerPtr->flags |= REQUESTED_REPACK;
-		Tcl_DoWhenIdle(ArrangePacking, packPtr->containerPtr);
+		TkScheduleLayout(packPtr->containerPtr->tkwin, ArrangePacking,
+		    packPtr->containerPtr);
 	    }
 	}
     } else if (eventPtr->type == DestroyNotify) {
@@ -1147,7 +1180,7 @@ PackStructureProc(
 	}
 
 	if (packPtr->flags & REQUESTED_REPACK) {
-	    Tcl_CancelIdleCall(ArrangePacking, packPtr);
+	    TkCancelLayout(ArrangePacking, packPtr);
 	}
 	packPtr->tkwin = NULL;
 	Tcl_EventuallyFree(packPtr, DestroyPacker);
@@ -1160,7 +1193,7 @@ PackStructureProc(
 	if ((packPtr->contentPtr != NULL)
 		&& !(packPtr->flags & REQUESTED_REPACK)) {
 	    packPtr->flags |= REQUESTED_REPACK;
-	    Tcl_DoWhenIdle(ArrangePacking, packPtr);
+	    TkScheduleLayout(packPtr->tkwin, ArrangePacking, packPtr);
 	}
     } else if (eventPtr->type == UnmapNotify) {
 	Packer *packPtr2;
@@ -1561,7 +1594,8 @@ ConfigureContent(
 	}
 	if (!(containerPtr->flags & REQUESTED_REPACK)) {
 	    containerPtr->flags |= REQUESTED_REPACK;
-	    Tcl_DoWhenIdle(ArrangePacking, containerPtr);
+	    TkScheduleLayout(containerPtr->tkwin, ArrangePacking,
+		containerPtr);
 	}
     }
     return TCL_OK;
@@ -852,6 +852,8 @@ RecomputePlacement(
     double x1, y1, x2, y2;
     int abort;			/* May get set to non-zero to abort this
 				 * placement operation. */
+    Tcl_WideInt statsStart;
+    Tk_Uid statsClass;
 
     containerPtr->flags &= ~PARENT_RECONFIG_PENDING;
 
@@ -867,6 +869,8 @@ RecomputePlacement(
     containerPtr->abortPtr = &abort;
     abort = 0;
     Tcl_Preserve(containerPtr);
+    statsStart = TkStatsStart();
+    statsClass = Tk_Class(containerPtr->tkwin);
 
     /*
      * Iterate over all the content windows for the container. Each content's geometry can
@@ -1039,6 +1043,9 @@ RecomputePlacement(
     }
 
     containerPtr->abortPtr = NULL;
+    if (statsStart != 0) {
+	TkStatsRecord(TK_STATS_GEOMETRY, statsClass, statsStart);
+    }
     Tcl_Release(containerPtr);
 }
 
@@ -173,6 +173,7 @@ static Tk_CustomOptionFreeProc CustomOptionFree;
 static Tcl_ObjCmdProc2 TestpropObjCmd;
 static Tcl_ObjCmdProc2 TestprintfObjCmd;
 #if !(defined(_WIN32) || defined(MAC_OSX_TK) || defined(__CYGWIN__))
+static Tcl_ObjCmdProc2 TestqueueeventsObjCmd;
 static Tcl_ObjCmdProc2 TestwrapperObjCmd;
 #endif
 static void		TrivialCmdDeletedProc(void *clientData);
@@ -253,6 +254,8 @@ Tktest_Init(
 #elif !defined(__CYGWIN__) && !defined(MAC_OSX_TK)
     Tcl_CreateObjCommand2(interp, "testmenubar", TestmenubarObjCmd,
 	    Tk_MainWindow(interp), NULL);
+    Tcl_CreateObjCommand2(interp, "testqueueevents", TestqueueeventsObjCmd,
+	    Tk_MainWindow(interp), NULL);
     Tcl_CreateObjCommand2(interp, "testsend", TkpTestsendCmd,
 	    Tk_MainWindow(interp), NULL);
     Tcl_CreateObjCommand2(interp, "testwrapper", TestwrapperObjCmd,
@@ -1926,6 +1929,83 @@ TestprintfObjCmd(
 }
 
 #if !(defined(_WIN32) || defined(MAC_OSX_TK) || defined(__CYGWIN__))
+/*
+ *----------------------------------------------------------------------
+ *
+ * TestqueueeventsObjCmd --
+ *
+ *	This function implements the "testqueueevents" command. It puts a
+ *	series of ConfigureNotify or Expose events for a window on the X event
+ *	queue, as if they had just been read from the server, so the
+ *	coalescing done while transferring them to Tcl can be tested. The
+ *	n-th ConfigureNotify event grows the window's width by n pixels; the
+ *	n-th Expose event covers the 10x10 square at n,n.
+ *
+ * Results:
+ *	A standard Tcl result.
+ *
+ * Side effects:
+ *	Adds events to the X event queue.
+ *
+ *----------------------------------------------------------------------
+ */
+
+static int
+TestqueueeventsObjCmd(
+    void *clientData,	/* Main window for application. */
+    Tcl_Interp *interp,		/* Current interpreter. */
+    Tcl_Size objc,			/* Number of arguments. */
+    Tcl_Obj *const objv[])		/* Argument strings. */
+{
+    static const char *const types[] = {"Configure", "Expose", NULL};
+    Tk_Window tkwin;
+    XEvent event;
+    int type, count;
+
+    if (objc != 4) {
+	Tcl_WrongNumArgs(interp, 1, objv, "window type count");
+	return TCL_ERROR;
+    }
+    tkwin = Tk_NameToWindow(interp, Tcl_GetString(objv[1]),
+	    (Tk_Window)clientData);
+    if (tkwin == NULL) {
+	return TCL_ERROR;
+    }
+    if (Tcl_GetIndexFromObj(interp, objv[2], types, "event type", 0,
+	    &type) != TCL_OK
+	    || Tcl_GetIntFromObj(interp, objv[3], &count) != TCL_OK) {
+	return TCL_ERROR;
+    }
+    Tk_MakeWindowExist(tkwin);
+
+    /*
+     * XPutBackEvent pushes onto the head of the queue, so queue the last
+     * event first.
+     */
+
+    while (count-- > 0) {
+	memset(&event, 0, sizeof(event));
+	event.xany.display = Tk_Display(tkwin);
+	event.xany.window = Tk_WindowId(tkwin);
+	if (type == 0) {
+	    event.type = ConfigureNotify;
+	    event.xconfigure.window = Tk_WindowId(tkwin);
+	    event.xconfigure.x = Tk_X(tkwin);
+	    event.xconfigure.y = Tk_Y(tkwin);
+	    event.xconfigure.width = Tk_Width(tkwin) + count + 1;
+	    event.xconfigure.height = Tk_Height(tkwin);
+	} else {
+	    event.type = Expose;
+	    event.xexpose.x = count + 1;
+	    event.xexpose.y = count + 1;
+	    event.xexpose.width = 10;
+	    event.xexpose.height = 10;
+	}
+	XPutBackEvent(Tk_Display(tkwin), &event);
+    }
+    return TCL_OK;
+}
+
 /*
  *----------------------------------------------------------------------
  *
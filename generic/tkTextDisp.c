@@ -722,7 +722,7 @@ TkTextFreeDInfo(
     }
     Tk_FreeGC(textPtr->display, dInfoPtr->scrollGC);
     if (dInfoPtr->flags & REDRAW_PENDING) {
-	Tcl_CancelIdleCall(DisplayText, textPtr);
+	TkCancelRedraw(DisplayText, textPtr);
     }
     if (dInfoPtr->lineUpdateTimer != NULL) {
 	Tcl_DeleteTimerHandler(dInfoPtr->lineUpdateTimer);
@@ -4174,6 +4174,8 @@ DisplayText(
     Tcl_Interp *interp;
     int padX, padY;
     int borderWidth, highlightWidth;
+    Tcl_WideInt statsStart;
+    Tk_Uid statsClass;
 
 
     if ((textPtr->tkwin == NULL) || (textPtr->flags & DESTROYED)) {
@@ -4186,6 +4188,8 @@ DisplayText(
 
     interp = textPtr->interp;
     Tcl_Preserve(interp);
+    statsStart = TkStatsStart();
+    statsClass = Tk_Class(textPtr->tkwin);
 
     if (tkTextDebug) {
 	CLEAR("tk_textRelayout");
@@ -4663,6 +4667,9 @@ DisplayText(
     }
 
   end:
+    if (statsStart != 0) {
+	TkStatsRecord(TK_STATS_REDISPLAY, statsClass, statsStart);
+    }
     Tcl_Release(interp);
 }
 
@@ -4692,7 +4699,7 @@ TkTextEventuallyRepick(
     dInfoPtr->flags |= REPICK_NEEDED;
     if (!(dInfoPtr->flags & REDRAW_PENDING)) {
 	dInfoPtr->flags |= REDRAW_PENDING;
-	Tcl_DoWhenIdle(DisplayText, textPtr);
+	TkScheduleRedraw(textPtr->tkwin, DisplayText, textPtr);
     }
 }
 
@@ -4742,7 +4749,7 @@ TkTextRedrawRegion(
 
     if (!(dInfoPtr->flags & REDRAW_PENDING)) {
 	dInfoPtr->flags |= REDRAW_PENDING;
-	Tcl_DoWhenIdle(DisplayText, textPtr);
+	TkScheduleRedraw(textPtr->tkwin, DisplayText, textPtr);
     }
 }
 
@@ -4882,7 +4889,7 @@ TextChanged(
      */
 
     if (!(dInfoPtr->flags & REDRAW_PENDING)) {
-	Tcl_DoWhenIdle(DisplayText, textPtr);
+	TkScheduleRedraw(textPtr->tkwin, DisplayText, textPtr);
     }
     dInfoPtr->flags |= REDRAW_PENDING|DINFO_OUT_OF_DATE|REPICK_NEEDED;
 
@@ -5119,7 +5126,7 @@ TextRedrawTag(
      */
 
     if (!(dInfoPtr->flags & REDRAW_PENDING)) {
-	Tcl_DoWhenIdle(DisplayText, textPtr);
+	TkScheduleRedraw(textPtr->tkwin, DisplayText, textPtr);
     }
     dInfoPtr->flags |= REDRAW_PENDING|DINFO_OUT_OF_DATE|REPICK_NEEDED;
 
@@ -5226,7 +5233,7 @@ TkTextRelayoutWindow(
      */
 
     if (!(dInfoPtr->flags & REDRAW_PENDING)) {
-	Tcl_DoWhenIdle(DisplayText, textPtr);
+	TkScheduleRedraw(textPtr->tkwin, DisplayText, textPtr);
 	inSync = 0;
     }
     dInfoPtr->flags |= REDRAW_PENDING|REDRAW_BORDERS|DINFO_OUT_OF_DATE
@@ -5530,7 +5537,7 @@ TkTextSetYView(
 
   scheduleUpdate:
     if (!(dInfoPtr->flags & REDRAW_PENDING)) {
-	Tcl_DoWhenIdle(DisplayText, textPtr);
+	TkScheduleRedraw(textPtr->tkwin, DisplayText, textPtr);
     }
     dInfoPtr->flags |= REDRAW_PENDING|DINFO_OUT_OF_DATE|REPICK_NEEDED;
 }
@@ -5847,7 +5854,7 @@ TkTextSeeCmd(
     dInfoPtr->flags |= DINFO_OUT_OF_DATE;
     if (!(dInfoPtr->flags & REDRAW_PENDING)) {
 	dInfoPtr->flags |= REDRAW_PENDING;
-	Tcl_DoWhenIdle(DisplayText, textPtr);
+	TkScheduleRedraw(textPtr->tkwin, DisplayText, textPtr);
     }
     return TCL_OK;
 }
@@ -5928,7 +5935,7 @@ TkTextXviewCmd(
     dInfoPtr->flags |= DINFO_OUT_OF_DATE;
     if (!(dInfoPtr->flags & REDRAW_PENDING)) {
 	dInfoPtr->flags |= REDRAW_PENDING;
-	Tcl_DoWhenIdle(DisplayText, textPtr);
+	TkScheduleRedraw(textPtr->tkwin, DisplayText, textPtr);
     }
     return TCL_OK;
 }
@@ -6013,7 +6020,7 @@ YScrollByPixels(
 	return;
     }
     if (!(dInfoPtr->flags & REDRAW_PENDING)) {
-	Tcl_DoWhenIdle(DisplayText, textPtr);
+	TkScheduleRedraw(textPtr->tkwin, DisplayText, textPtr);
     }
     dInfoPtr->flags |= REDRAW_PENDING|DINFO_OUT_OF_DATE|REPICK_NEEDED;
 }
@@ -6148,7 +6155,7 @@ YScrollByLines(
 
   scheduleUpdate:
     if (!(dInfoPtr->flags & REDRAW_PENDING)) {
-	Tcl_DoWhenIdle(DisplayText, textPtr);
+	TkScheduleRedraw(textPtr->tkwin, DisplayText, textPtr);
     }
     dInfoPtr->flags |= REDRAW_PENDING|DINFO_OUT_OF_DATE|REPICK_NEEDED;
 }
@@ -6453,7 +6460,7 @@ TkTextScanCmd(
 	dInfoPtr->flags |= DINFO_OUT_OF_DATE;
 	if (!(dInfoPtr->flags & REDRAW_PENDING)) {
 	    dInfoPtr->flags |= REDRAW_PENDING;
-	    Tcl_DoWhenIdle(DisplayText, textPtr);
+	    TkScheduleRedraw(textPtr->tkwin, DisplayText, textPtr);
 	}
     } else if (c=='m' && strncmp(Tcl_GetString(objv[2]), "mark", length)==0) {
 	dInfoPtr->scanMarkXPixel = dInfoPtr->newXPixelOffset;
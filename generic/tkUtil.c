@@ -1283,6 +1283,62 @@ TkScalingLevel(
     }
 }
 
+/*
+ *----------------------------------------------------------------------
+ *
+ * TkAccumulateExpose --
+ *
+ *	Collect the exact area of a series of Expose or GraphicsExpose events
+ *	for a window. The caller keeps *regionPtr (initially NULL) between
+ *	events, and redraws once the series is complete, clipped to the
+ *	returned region instead of the bounding box of all the events.
+ *
+ * Results:
+ *	NULL while more events of the series are to follow. For the last
+ *	event, the accumulated region in window coordinates; the caller must
+ *	release it with TkDestroyRegion.
+ *
+ * Side effects:
+ *	*regionPtr is created on the first event, and reset to NULL when it
+ *	is returned.
+ *
+ *----------------------------------------------------------------------
+ */
+
+TkRegion
+TkAccumulateExpose(
+    TkRegion *regionPtr,	/* Region of the current series of events. */
+    XEvent *eventPtr)		/* Expose or GraphicsExpose event. */
+{
+    XRectangle rect;
+    TkRegion region;
+    int count;
+
+    if (eventPtr->type == GraphicsExpose) {
+	rect.x = eventPtr->xgraphicsexpose.x;
+	rect.y = eventPtr->xgraphicsexpose.y;
+	rect.width = eventPtr->xgraphicsexpose.width;
+	rect.height = eventPtr->xgraphicsexpose.height;
+	count = eventPtr->xgraphicsexpose.count;
+    } else {
+	rect.x = eventPtr->xexpose.x;
+	rect.y = eventPtr->xexpose.y;
+	rect.width = eventPtr->xexpose.width;
+	rect.height = eventPtr->xexpose.height;
+	count = eventPtr->xexpose.count;
+    }
+    if (*regionPtr == NULL) {
+	*regionPtr = TkCreateRegion();
+    }
+    TkUnionRectWithRegion(&rect, *regionPtr, *regionPtr);
+    if (count > 0) {
+	return NULL;
+    }
+    region = *regionPtr;
+    *regionPtr = NULL;
+    return region;
+}
+
 /*
  *----------------------------------------------------------------------
  *
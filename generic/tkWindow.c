@@ -676,6 +676,7 @@ TkAllocWindow(
     winPtr->geomData = NULL;
     winPtr->geomMgrName = NULL;
     winPtr->maintainerPtr = NULL;
+    winPtr->coalesceMask = -1;
     winPtr->reqWidth = winPtr->reqHeight = 1;
     winPtr->internalBorderLeft = 0;
     winPtr->wmInfoPtr = NULL;
@@ -44,6 +44,7 @@ struct Ttk_ResourceCache_ {
     Tcl_HashTable imageTable;	/* Entries: Tk_Images */
 
     Tcl_HashTable namedColors;	/* Entries: RGB values as Tcl_StringObjs */
+    size_t epoch;		/* See TtkResourceCacheEpoch() */
 };
 
 /*
@@ -56,6 +57,7 @@ Ttk_ResourceCache Ttk_CreateResourceCache(Tcl_Interp *interp)
 
     cache->tkwin = NULL;	/* initialized later */
     cache->interp = interp;
+    cache->epoch = 0;
     Tcl_InitHashTable(&cache->fontTable, TCL_STRING_KEYS);
     Tcl_InitHashTable(&cache->colorTable, TCL_STRING_KEYS);
     Tcl_InitHashTable(&cache->borderTable, TCL_STRING_KEYS);
@@ -74,6 +76,8 @@ static void Ttk_ClearCache(Ttk_ResourceCache cache)
     Tcl_HashSearch search;
     Tcl_HashEntry *entryPtr;
 
+    TtkNewResourceCacheEpoch(cache);
+
     /*
      * Free fonts:
      */
@@ -136,6 +140,22 @@ static void Ttk_ClearCache(Ttk_ResourceCache cache)
     return;
 }
 
+/*
+ * TtkResourceCacheEpoch, TtkNewResourceCacheEpoch --
+ *	The epoch changes whenever previously returned resources may
+ *	have been released, or style settings have changed.  Anything
+ *	derived from them must be recomputed when the epoch changes.
+ */
+size_t TtkResourceCacheEpoch(Ttk_ResourceCache cache)
+{
+    return cache->epoch;
+}
+
+void TtkNewResourceCacheEpoch(Ttk_ResourceCache cache)
+{
+    ++cache->epoch;
+}
+
 /*
  * Ttk_FreeResourceCache --
  *	Release references to all cached resources, delete the cache.
@@ -603,6 +603,12 @@ static int LabelframeConfigure(Tcl_Interp *interp,void *recordPtr,int mask)
 	return TCL_ERROR;
     }
 
+    /* The label sublayout shares the widget record:
+     */
+    if (lframePtr->label.labelLayout) {
+	Ttk_InvalidateLayout(lframePtr->label.labelLayout);
+    }
+
     /* Update -labelwidget changes, if any:
      */
     if (mask & LABELWIDGET_CHANGED) {
@@ -26,6 +26,7 @@ struct TtkImageSpec {
     Tk_Image		*images;	/* ... per-state images to use */
     Tk_ImageChangedProc *imageChanged;
     void		*imageChangedClientData;
+    Tcl_Size		refCount;	/* See TtkShareImageSpec */
 };
 
 /* NullImageChanged --
@@ -90,6 +91,7 @@ TtkGetImageSpecEx(Tcl_Interp *interp, Tk_Window tkwin, Tcl_Obj *objPtr,
     imageSpec->images = 0;
     imageSpec->imageChanged = imageChangedProc;
     imageSpec->imageChangedClientData = imageChangedClientData;
+    imageSpec->refCount = 1;
 
     if (Tcl_ListObjGetElements(interp, objPtr, &objc, &objv) != TCL_OK) {
 	goto error;
@@ -144,13 +146,29 @@ error:
     return NULL;
 }
 
+/* TtkShareImageSpec --
+ *	Returns another reference to an image specification, so that
+ *	several owners can use one set of image instances. Each reference
+ *	is released with TtkFreeImageSpec.
+ */
+Ttk_ImageSpec *TtkShareImageSpec(Ttk_ImageSpec *imageSpec)
+{
+    ++imageSpec->refCount;
+    return imageSpec;
+}
+
 /* TtkFreeImageSpec --
- *	Dispose of an image specification.
+ *	Release a reference to an image specification; dispose of it
+ *	when the last one is gone.
  */
 void TtkFreeImageSpec(Ttk_ImageSpec *imageSpec)
 {
     int i;
 
+    if (--imageSpec->refCount > 0) {
+	return;
+    }
+
     for (i=0; i < imageSpec->mapCount; ++i) {
 	Tk_FreeImage(imageSpec->images[i]);
     }
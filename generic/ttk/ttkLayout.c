@@ -527,6 +527,8 @@ struct Ttk_LayoutNode_
     Ttk_ElementClass	*eclass;	/* Class record */
     Ttk_State		state;		/* Current state */
     Ttk_Box		parcel;		/* allocated parcel */
+    int			modified;	/* State or anchor changed; see
+					 * ValidateLayoutCache() */
     Ttk_LayoutNode	*next, *child;
 };
 
@@ -538,6 +540,7 @@ static Ttk_LayoutNode *Ttk_NewLayoutNode(
     node->flags = flags;
     node->eclass = elementClass;
     node->state = 0u;
+    node->modified = 0;
     node->next = node->child = 0;
     node->parcel = Ttk_MakeBox(0,0,0,0);
 
@@ -845,8 +848,20 @@ struct Ttk_Layout_
     Tk_OptionTable	optionTable;
     Tk_Window		tkwin;
     Ttk_LayoutNode	*root;
+
+    /* Memoized results of Ttk_LayoutSize() and Ttk_PlaceLayout():
+     */
+    int			cacheFlags;	/* LAYOUT_SIZE_CACHED|LAYOUT_PLACE_CACHED */
+    size_t		cacheEpoch;	/* Style epoch of cached results */
+    Ttk_State		sizeState;	/* State used for reqWidth, reqHeight */
+    int			reqWidth, reqHeight;
+    Ttk_State		placeState;	/* State used for last placement */
+    Ttk_Box		placeBox;	/* Parcel used for last placement */
 };
 
+#define LAYOUT_SIZE_CACHED	0x1
+#define LAYOUT_PLACE_CACHED	0x2
+
 static Ttk_Layout TTKNewLayout(
     Ttk_Style style,
     void *recordPtr,Tk_OptionTable optionTable, Tk_Window tkwin,
@@ -858,6 +873,8 @@ static Ttk_Layout TTKNewLayout(
     layout->optionTable = optionTable;
     layout->tkwin = tkwin;
     layout->root = root;
+    layout->cacheFlags = 0;
+    layout->cacheEpoch = 0;
     return layout;
 }
 
@@ -948,6 +965,55 @@ Ttk_CreateSublayout(
 void Ttk_RebindSublayout(Ttk_Layout layout, void *recordPtr)
 {
     layout->recordPtr = recordPtr;
+    layout->cacheFlags = 0;
+}
+
+/* Ttk_InvalidateLayout --
+ *	Discard the layout's cached size and placement.
+ *	Must be called whenever the data record changes in a way
+ *	that may affect element sizes, e.g. after widget configuration.
+ */
+void Ttk_InvalidateLayout(Ttk_Layout layout)
+{
+    layout->cacheFlags = 0;
+}
+
+/* ClearModifiedNodes --
+ *	Reset the 'modified' flag of every node in a layout tree.
+ *	Returns: nonzero if any node was modified.
+ */
+static int ClearModifiedNodes(Ttk_LayoutNode *node)
+{
+    int modified = 0;
+
+    for (; node; node = node->next) {
+	if (node->modified) {
+	    node->modified = 0;
+	    modified = 1;
+	}
+	if (ClearModifiedNodes(node->child)) {
+	    modified = 1;
+	}
+    }
+    return modified;
+}
+
+/* ValidateLayoutCache --
+ *	Discard cached results if the style settings have changed
+ *	or if element states or anchors were changed since they
+ *	were computed.
+ */
+static void ValidateLayoutCache(Ttk_Layout layout)
+{
+    size_t epoch = Ttk_StyleEpoch(layout->style);
+
+    if (layout->cacheEpoch != epoch) {
+	layout->cacheEpoch = epoch;
+	layout->cacheFlags = 0;
+    }
+    if (ClearModifiedNodes(layout->root)) {
+	layout->cacheFlags = 0;
+    }
 }
 
 /*
@@ -1053,11 +1119,21 @@ Ttk_Box Ttk_LayoutNodeInternalParcel(Ttk_Layout layout, Ttk_LayoutNode *node)
 
 /* Ttk_LayoutSize --
  *	Compute requested size of a layout.
+ *	The result is cached until the state, style or data record changes.
  */
 void Ttk_LayoutSize(
     Ttk_Layout layout, Ttk_State state, int *widthPtr, int *heightPtr)
 {
-    Ttk_NodeListSize(layout, layout->root, state, widthPtr, heightPtr);
+    ValidateLayoutCache(layout);
+    if (!(layout->cacheFlags & LAYOUT_SIZE_CACHED)
+	    || layout->sizeState != state) {
+	Ttk_NodeListSize(layout, layout->root, state,
+		&layout->reqWidth, &layout->reqHeight);
+	layout->sizeState = state;
+	layout->cacheFlags |= LAYOUT_SIZE_CACHED;
+    }
+    *widthPtr = layout->reqWidth;
+    *heightPtr = layout->reqHeight;
 }
 
 void Ttk_LayoutNodeReqSize(	/* @@@ Rename this */
@@ -1100,9 +1176,23 @@ static void Ttk_PlaceNodeList(
     }
 }
 
+/* Ttk_PlaceLayout --
+ *	Compute parcels for all nodes in a layout.
+ *	Skipped if the layout was last placed in the same state and parcel
+ *	and nothing has changed since.
+ */
 void Ttk_PlaceLayout(Ttk_Layout layout, Ttk_State state, Ttk_Box b)
 {
+    ValidateLayoutCache(layout);
+    if ((layout->cacheFlags & LAYOUT_PLACE_CACHED)
+	    && layout->placeState == state
+	    && TtkBoxEqual(layout->placeBox, b)) {
+	return;
+    }
     Ttk_PlaceNodeList(layout, layout->root, state,  b);
+    layout->placeState = state;
+    layout->placeBox = b;
+    layout->cacheFlags |= LAYOUT_PLACE_CACHED;
 }
 
 /*------------------------------------------------------------------------
@@ -1249,6 +1339,7 @@ Ttk_Box Ttk_ElementParcel(Ttk_Element node)
  */
 void Ttk_PlaceElement(Ttk_Layout layout, Ttk_Element node, Ttk_Box b)
 {
+    layout->cacheFlags &= ~LAYOUT_PLACE_CACHED;
     node->parcel = b;
     if (node->child) {
 	Ttk_PlaceNodeList(layout, node->child, 0,
@@ -1284,7 +1375,12 @@ static Ttk_PositionSpec AnchorToPosition(Tk_Anchor anchor)
  */
 void Ttk_AnchorElement(Ttk_Element node, Tk_Anchor anchor)
 {
-    node->flags = AnchorToPosition(anchor);
+    Ttk_PositionSpec flags = AnchorToPosition(anchor);
+
+    if (node->flags != flags) {
+	node->flags = flags;
+	node->modified = 1;
+    }
 }
 
 /*
@@ -1292,7 +1388,12 @@ void Ttk_AnchorElement(Ttk_Element node, Tk_Anchor anchor)
  */
 void Ttk_ChangeElementState(Ttk_LayoutNode *node,unsigned set,unsigned clr)
 {
-    node->state = (node->state | set) & ~clr;
+    Ttk_State state = (node->state | set) & ~clr;
+
+    if (node->state != state) {
+	node->state = state;
+	node->modified = 1;
+    }
 }
 
 /*EOF*/
@@ -123,8 +123,17 @@ struct Ttk_ElementClass_ {
     int nResources;		/* #Element options */
     Tcl_Obj **defaultValues;	/* Array of option default values */
     Tcl_HashTable optMapCache;	/* Map: Tk_OptionTable * -> OptionMap */
+    Tcl_HashTable resolvedCache;/* Map: ResolvedKey -> resolved values */
+    size_t cacheEpoch;		/* Resource cache epoch of resolvedCache */
 };
 
+/* Key for the resolvedCache table:
+ */
+typedef struct {
+    Ttk_Style style;
+    Ttk_State state;
+} ResolvedKey;
+
 /* TTKGetOptionSpec --
  *	Look up a Tk_OptionSpec by name from a Tk_OptionTable,
  *	and verify that it's compatible with the specified Tk_OptionType,
@@ -246,13 +255,35 @@ NewElementClass(const char *name, const Ttk_ElementSpec *specPtr, void *clientDa
 	}
     }
 
-    /* Initialize option map cache:
+    /* Initialize option map cache and resolved value cache:
      */
     Tcl_InitHashTable(&elementClass->optMapCache, TCL_ONE_WORD_KEYS);
+    Tcl_InitHashTable(&elementClass->resolvedCache,
+	    sizeof(ResolvedKey) / sizeof(int));
+    elementClass->cacheEpoch = 0;
 
     return elementClass;
 }
 
+/*
+ * FlushResolvedCache --
+ *	Discard all resolved option values of an element class.
+ */
+static void FlushResolvedCache(Ttk_ElementClass *elementClass)
+{
+    Tcl_HashSearch search;
+    Tcl_HashEntry *entryPtr;
+
+    entryPtr = Tcl_FirstHashEntry(&elementClass->resolvedCache, &search);
+    while (entryPtr != NULL) {
+	ckfree(Tcl_GetHashValue(entryPtr));
+	entryPtr = Tcl_NextHashEntry(&search);
+    }
+    Tcl_DeleteHashTable(&elementClass->resolvedCache);
+    Tcl_InitHashTable(&elementClass->resolvedCache,
+	    sizeof(ResolvedKey) / sizeof(int));
+}
+
 /*
  * FreeElementClass --
  *	Release resources associated with an element class record.
@@ -283,6 +314,9 @@ static void FreeElementClass(Ttk_ElementClass *elementClass)
     }
     Tcl_DeleteHashTable(&elementClass->optMapCache);
 
+    FlushResolvedCache(elementClass);
+    Tcl_DeleteHashTable(&elementClass->resolvedCache);
+
     ckfree(elementClass->elementRecord);
     ckfree(elementClass);
 }
@@ -517,6 +551,7 @@ static void ThemeChangedProc(void *clientData)
 static void ThemeChanged(StylePackageData *pkgPtr)
 {
     TtkSetBlinkCursorTimes(pkgPtr->interp);
+    TtkNewResourceCacheEpoch(pkgPtr->cache);
 
     if (!pkgPtr->themeChangePending) {
 	Tcl_DoWhenIdle(ThemeChangedProc, pkgPtr);
@@ -758,6 +793,16 @@ const char *Ttk_StyleName(Ttk_Style stylePtr)
     return stylePtr->styleName;
 }
 
+/*
+ * Ttk_StyleEpoch --
+ *	Return the resource cache epoch of the style;
+ *	see TtkResourceCacheEpoch().
+ */
+size_t Ttk_StyleEpoch(Ttk_Style stylePtr)
+{
+    return stylePtr->cache ? TtkResourceCacheEpoch(stylePtr->cache) : 0;
+}
+
 /*
  * Ttk_GetElement --
  *	Look up an element class by name in a given theme.
@@ -969,6 +1014,68 @@ static int AllocateResource(
     }
 }
 
+/*
+ * GetResolvedValues --
+ *	Return the values of an element's options that come from the
+ *	style, for the specified state: from the dynamic state map if
+ *	specified, otherwise from the style default, otherwise the default
+ *	value specified at registration time, after AllocateResource().
+ *
+ *	These only depend on the style and the state, so they are
+ *	computed once and cached in the element class until the style
+ *	settings change or the resource cache is cleared.  The result
+ *	is an array of nResources values, followed by nResources flags
+ *	set for values that could not be allocated.
+ */
+static Tcl_Obj **GetResolvedValues(
+    Ttk_ElementClass *eclass,
+    Ttk_Style style,
+    Tk_Window tkwin,
+    Ttk_State state)
+{
+    int nResources = eclass->nResources;
+    Ttk_ResourceCache cache = style->cache;
+    const Ttk_ElementOptionSpec *elementOption = eclass->specPtr->options;
+    size_t epoch = TtkResourceCacheEpoch(cache);
+    Tcl_HashEntry *entryPtr;
+    ResolvedKey key;
+    Tcl_Obj **values;
+    char *failed;
+    int i, isNew;
+
+    if (eclass->cacheEpoch != epoch) {
+	FlushResolvedCache(eclass);
+	eclass->cacheEpoch = epoch;
+    }
+
+    memset(&key, 0, sizeof(key));
+    key.style = style;
+    key.state = state;
+    entryPtr = Tcl_CreateHashEntry(&eclass->resolvedCache, &key, &isNew);
+    if (!isNew) {
+	return (Tcl_Obj **)Tcl_GetHashValue(entryPtr);
+    }
+
+    values = (Tcl_Obj **)ckalloc(nResources * (sizeof(Tcl_Obj *) + 1) + 1);
+    failed = (char *)(values + nResources);
+    for (i=0; i<nResources; ++i, ++elementOption) {
+	const char *optionName = elementOption->optionName;
+	Tcl_Obj *dynamicSetting = Ttk_StyleMap(style, optionName, state);
+
+	if (dynamicSetting) {
+	    values[i] = dynamicSetting;
+	} else {
+	    Tcl_Obj *styleDefault = Ttk_StyleDefault(style, optionName);
+	    values[i] = styleDefault ? styleDefault : eclass->defaultValues[i];
+	}
+	failed[i] = !AllocateResource(cache, tkwin, &values[i],
+		elementOption->type);
+    }
+    Tcl_SetHashValue(entryPtr, values);
+
+    return values;
+}
+
 /*
  * InitializeElementRecord --
  *
@@ -978,6 +1085,7 @@ static int AllocateResource(
  *	otherwise the dynamic state map if specified,
  *	otherwise from the corresponding widget resource if present,
  *	otherwise the default value specified at registration time.
+ *	See GetResolvedValues() for all but the first.
  *
  * Returns:
  *	1 if OK, 0 if an error is detected.
@@ -1000,15 +1108,14 @@ int InitializeElementRecord(
     int nResources = eclass->nResources;
     Ttk_ResourceCache cache = style->cache;
     const Ttk_ElementOptionSpec *elementOption = eclass->specPtr->options;
+    Tcl_Obj **resolved = GetResolvedValues(eclass, style, tkwin, state);
+    const char *failed = (const char *)(resolved + nResources);
 
     int i;
     for (i=0; i<nResources; ++i, ++elementOption) {
 	Tcl_Obj **dest = (Tcl_Obj **)
 	    ((char *)elementRecord + elementOption->offset);
-	const char *optionName = elementOption->optionName;
-	Tcl_Obj *dynamicSetting = Ttk_StyleMap(style, optionName, state);
 	Tcl_Obj *widgetValue = 0;
-	Tcl_Obj *elementDefault = eclass->defaultValues[i];
 
 	if (optionMap[i]) {
 	    widgetValue = *(Tcl_Obj **)
@@ -1017,15 +1124,13 @@ int InitializeElementRecord(
 
 	if (widgetValue) {
 	    *dest = widgetValue;
-	} else if (dynamicSetting) {
-	    *dest = dynamicSetting;
-	} else {
-	    Tcl_Obj *styleDefault = Ttk_StyleDefault(style, optionName);
-	    *dest = styleDefault ? styleDefault : elementDefault;
-	}
-
-	if (!AllocateResource(cache, tkwin, dest, elementOption->type)) {
+	    if (!AllocateResource(cache, tkwin, dest, elementOption->type)) {
+		return 0;
+	    }
+	} else if (failed[i]) {
 	    return 0;
+	} else {
+	    *dest = resolved[i];
 	}
     }
 
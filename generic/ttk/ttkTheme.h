@@ -284,6 +284,7 @@ MODULE_SCOPE void Ttk_PlaceLayout(Ttk_Layout, Ttk_State, Ttk_Box);
 MODULE_SCOPE void Ttk_DrawLayout(Ttk_Layout, Ttk_State, Drawable);
 
 MODULE_SCOPE void Ttk_RebindSublayout(Ttk_Layout, void *recordPtr);
+MODULE_SCOPE void Ttk_InvalidateLayout(Ttk_Layout);
 
 MODULE_SCOPE Ttk_Element Ttk_IdentifyElement(Ttk_Layout, int x, int y);
 MODULE_SCOPE Ttk_Element Ttk_FindElement(Ttk_Layout, const char *nodeName);
@@ -324,6 +325,9 @@ MODULE_SCOPE Tk_Image Ttk_UseImage(Ttk_ResourceCache, Tk_Window, Tcl_Obj *);
 
 MODULE_SCOPE void Ttk_RegisterNamedColor(Ttk_ResourceCache, const char *, XColor *);
 
+MODULE_SCOPE size_t TtkResourceCacheEpoch(Ttk_ResourceCache);
+MODULE_SCOPE void TtkNewResourceCacheEpoch(Ttk_ResourceCache);
+
 /*------------------------------------------------------------------------
  * +++ Image specifications.
  */
@@ -332,6 +336,7 @@ typedef struct TtkImageSpec Ttk_ImageSpec;
 TTKAPI Ttk_ImageSpec *TtkGetImageSpec(Tcl_Interp *, Tk_Window, Tcl_Obj *);
 TTKAPI Ttk_ImageSpec *TtkGetImageSpecEx(Tcl_Interp *, Tk_Window, Tcl_Obj *,
 					Tk_ImageChangedProc *, void *);
+TTKAPI Ttk_ImageSpec *TtkShareImageSpec(Ttk_ImageSpec *);
 TTKAPI void TtkFreeImageSpec(Ttk_ImageSpec *);
 TTKAPI Tk_Image TtkSelectImage(Ttk_ImageSpec *, Tk_Window, Ttk_State);
 
@@ -47,6 +47,7 @@ MODULE_SCOPE Ttk_LayoutTemplate Ttk_FindLayoutTemplate(
     Ttk_Theme themePtr, const char *layoutName);
 
 MODULE_SCOPE const char *Ttk_StyleName(Ttk_Style);
+MODULE_SCOPE size_t Ttk_StyleEpoch(Ttk_Style);
 
 MODULE_SCOPE void TtkSetBlinkCursorTimes(Tcl_Interp* interp);
 
@@ -18,6 +18,7 @@
 #define DEF_TITLECOLUMNS	"0"
 #define DEF_TITLEITEMS		"0"
 #define DEF_STRIPED		"0"
+#define DEF_VIRTUALROWS		"0"
 #define DEF_COLWIDTH		"200"
 #define DEF_MINWIDTH		"20"
 
@@ -40,6 +41,7 @@ static const int HALO	= 4;	/* heading separator */
 typedef struct TreeItemRec TreeItem;
 struct TreeItemRec {
     Tcl_HashEntry *entryPtr;	/* Back-pointer to hash table entry */
+    Tcl_Obj	*idObj;		/* Cached item ID, see ItemID() */
     TreeItem	*parent;	/* Parent item */
     TreeItem	*children;	/* Linked list of child items */
     TreeItem	*next;		/* Next sibling */
@@ -74,6 +76,7 @@ struct TreeItemRec {
 
 #define ITEM_OPTION_TAGS_CHANGED	0x100
 #define ITEM_OPTION_IMAGE_CHANGED	0x200
+#define ITEM_OPTION_LAYOUT_CHANGED	0x400	/* may move other items */
 
 static const Tk_OptionSpec ItemOptionSpecs[] = {
     {TK_OPTION_STRING, "-text", "text", "Text",
@@ -81,10 +84,10 @@ static const Tk_OptionSpec ItemOptionSpecs[] = {
 	0,0,0 },
     {TK_OPTION_INT, "-height", "height", "Height",
 	"1", TCL_INDEX_NONE, offsetof(TreeItem,height),
-	0,0,0 },
+	0,0,ITEM_OPTION_LAYOUT_CHANGED },
     {TK_OPTION_BOOLEAN, "-hidden", "hidden", "Hidden",
 	"0", TCL_INDEX_NONE, offsetof(TreeItem,hidden),
-	0,0,0 },
+	0,0,ITEM_OPTION_LAYOUT_CHANGED },
     {TK_OPTION_STRING, "-image", "image", "Image",
 	NULL, offsetof(TreeItem,imageObj), TCL_INDEX_NONE,
 	TK_OPTION_NULL_OK,0,ITEM_OPTION_IMAGE_CHANGED },
@@ -96,7 +99,7 @@ static const Tk_OptionSpec ItemOptionSpecs[] = {
 	TK_OPTION_NULL_OK,0,0 },
     {TK_OPTION_BOOLEAN, "-open", "open", "Open",
 	"0", offsetof(TreeItem,openObj), TCL_INDEX_NONE,
-	0,0,0 },
+	0,0,ITEM_OPTION_LAYOUT_CHANGED },
     {TK_OPTION_STRING, "-tags", "tags", "Tags",
 	NULL, offsetof(TreeItem,tagsObj), TCL_INDEX_NONE,
 	TK_OPTION_NULL_OK,0,ITEM_OPTION_TAGS_CHANGED },
@@ -116,6 +119,7 @@ static TreeItem *NewItem(void)
     TreeItem *item = (TreeItem *)ckalloc(sizeof(*item));
 
     item->entryPtr = 0;
+    item->idObj = NULL;
     item->parent = item->children = item->next = item->prev = NULL;
 
     item->state = 0ul;
@@ -133,6 +137,8 @@ static TreeItem *NewItem(void)
 
     item->tagset = NULL;
     item->imagespec = NULL;
+    item->itemPos = INT_MAX;	/* not numbered yet */
+    item->visiblePos = item->rowPos = -1;
 
     return item;
 }
@@ -143,6 +149,7 @@ static TreeItem *NewItem(void)
 static void FreeItem(TreeItem *item)
 {
     Tcl_Size i;
+    if (item->idObj) { Tcl_DecrRefCount(item->idObj); }
     if (item->textObj) { Tcl_DecrRefCount(item->textObj); }
     if (item->imageObj) { Tcl_DecrRefCount(item->imageObj); }
     if (item->valuesObj) { Tcl_DecrRefCount(item->valuesObj); }
@@ -430,6 +437,16 @@ static int GetEnumSetFromObj(
  *	headingHeight: [layout]
  *	rowHeight, indent: style
  */
+
+/* A materialized virtual row, on the LRU list of the treeview:
+ */
+typedef struct VirtualRow {
+    TreeItem *item;		/* Item holding the row's options */
+    Tcl_HashEntry *entryPtr;	/* Entry in tree.virtualTable */
+    struct VirtualRow *prev;	/* More recently displayed row */
+    struct VirtualRow *next;	/* Less recently displayed row */
+} VirtualRow;
+
 typedef struct {
     /* Resources acquired at initialization-time:
      */
@@ -456,6 +473,8 @@ typedef struct {
     /* Tree data:
      */
     Tcl_HashTable items;	/* Map: item name -> item */
+    size_t itemEpoch;		/* Validates cached item handles,
+				 * see FindItem */
     int serial;			/* Next item # for autogenerated names */
     TreeItem *root;		/* Root item */
 
@@ -495,10 +514,36 @@ typedef struct {
     int titleRows;		/* Height of non-scrolled items, in rows */
     int totalRows;		/* Height of non-hidden items, in rows */
     int rowPosNeedsUpdate;	/* Internal rowPos data needs update */
+    TreeItem **rowIndex;	/* Visible items in display order, by
+				 * visiblePos; valid with rowPos */
+    Tcl_Size nRowIndex;		/* #items in rowIndex */
+    TreeItem **itemOrder;	/* All items in preorder, by itemPos */
+    Tcl_Size rowIndexSize;	/* #allocated entries in rowIndex and
+				 * itemOrder */
+    int validItems;		/* #entries of itemOrder, and ... */
+    Tcl_Size validVisible;	/* ... of rowIndex with valid position
+				 * data, see InvalidatePositions */
     Ttk_Box headingArea;	/* Display area for column headings */
     Ttk_Box treeArea;	/* Display area for tree */
     int slack;			/* Slack space (see Resizing section) */
     unsigned showFlags;		/* bitmask of subparts to display */
+
+    /* Virtual rows, see below:
+     */
+    Tcl_Obj *rowCommandObj;	/* -rowcommand option */
+    Tcl_Size virtualRows;	/* -virtualrows option */
+    int virtualFirstRow;	/* Row of the first virtual row */
+    Tcl_HashTable virtualTable;	/* Map: row index -> VirtualRow */
+    VirtualRow *lruFirst;	/* Most recently displayed virtual row */
+    VirtualRow *lruLast;	/* Least recently displayed virtual row */
+    int fetchPending;		/* FetchVirtualRows() is scheduled */
+
+    /* Partial redisplay, see RedisplayItem:
+     */
+    char *damagedRows;		/* Flags: display row must be redrawn */
+    int damagedRowsSize;	/* #allocated entries in damagedRows */
+    int nDamagedRows;		/* #flags set in damagedRows */
+    int damagePending;		/* RedrawDamagedRows() is scheduled */
 } TreePart;
 
 typedef struct {
@@ -506,11 +551,20 @@ typedef struct {
     TreePart tree;
 } Treeview;
 
+static void InvalidatePositions(Treeview *, TreeItem *);
+static void UpdatePositionTree(Treeview *);
+static void RedisplayItem(Treeview *, TreeItem *);
+static void ClearDamage(Treeview *);
+static void RedrawDamagedRows(void *);
+static void FlushVirtualRows(Treeview *, Tcl_WideInt, Tcl_WideInt);
+static void FetchVirtualRows(void *);
+
 #define USER_MASK		0x0100
 #define COLUMNS_CHANGED	(USER_MASK)
 #define DCOLUMNS_CHANGED	(USER_MASK<<1)
 #define SCROLLCMD_CHANGED	(USER_MASK<<2)
 #define SHOW_CHANGED		(USER_MASK<<3)
+#define VIRTUAL_CHANGED		(USER_MASK<<4)
 
 static const char *const SelectModeStrings[] = { "none", "browse", "extended", NULL };
 static const char *const SelectTypeStrings[] = { "item", "cell", NULL };
@@ -548,6 +602,12 @@ static const Tk_OptionSpec TreeviewOptionSpecs[] = {
     {TK_OPTION_BOOLEAN, "-striped", "striped", "Striped",
 	DEF_STRIPED, TCL_INDEX_NONE, offsetof(Treeview,tree.striped),
 	0, 0, GEOMETRY_CHANGED},
+    {TK_OPTION_STRING, "-rowcommand", "rowCommand", "RowCommand",
+	NULL, offsetof(Treeview,tree.rowCommandObj), TCL_INDEX_NONE,
+	TK_OPTION_NULL_OK, 0, VIRTUAL_CHANGED},
+    {TK_OPTION_INT, "-virtualrows", "virtualRows", "VirtualRows",
+	DEF_VIRTUALROWS, TCL_INDEX_NONE, offsetof(Treeview,tree.virtualRows),
+	TK_OPTION_VAR(Tcl_Size), 0, VIRTUAL_CHANGED},
 
     {TK_OPTION_STRING, "-xscrollcommand", "xScrollCommand", "ScrollCommand",
 	NULL, offsetof(Treeview, tree.xscroll.scrollCmdObj), TCL_INDEX_NONE,
@@ -703,6 +763,84 @@ static TreeColumn *FindColumn(
     return GetColumn(interp, tv, columnIDObj);
 }
 
+/*------------------------------------------------------------------------
+ * +++ Item handles.
+ *
+ * The "treeitem" object type caches the TreeItem an item identifier
+ * resolved to, so that repeated lookups skip the hash table.
+ * The cache is only valid while the item epoch it was resolved in
+ * is current.  Epochs are unique across all treeviews, and a treeview
+ * starts a new one whenever items are freed, so a stale handle can
+ * never match an item of another treeview or a freed item.
+ */
+
+#define GET_TREEITEM(objPtr) \
+	((TreeItem *) (objPtr)->internalRep.twoPtrValue.ptr1)
+#define GET_ITEMEPOCH(objPtr) \
+	((size_t) (objPtr)->internalRep.twoPtrValue.ptr2)
+
+static void DupTreeItemInternalRep(Tcl_Obj *srcPtr, Tcl_Obj *copyPtr);
+
+static TkObjType treeItemObjType = {
+    NULL, 0
+};
+TCL_DECLARE_MUTEX(treeItemTypeMutex)
+
+/* + TreeItemTypeInit --
+ *	Creates the "treeitem" object type, once per process.
+ *	Called from TtkTreeview_Init, before any treeview exists.
+ */
+static void TreeItemTypeInit(void)
+{
+    Tcl_MutexLock(&treeItemTypeMutex);
+    if (treeItemObjType.objTypePtr == NULL) {
+	Tcl_ObjType *otPtr = Tcl_NewObjType();
+	Tcl_ObjTypeSetName(otPtr, (char *)"treeitem");
+	Tcl_ObjTypeSetVersion(otPtr, 1);
+	Tcl_ObjTypeSetDupInternalRepProc(otPtr, DupTreeItemInternalRep);
+	treeItemObjType.objTypePtr = otPtr;
+    }
+    Tcl_MutexUnlock(&treeItemTypeMutex);
+}
+
+static void DupTreeItemInternalRep(Tcl_Obj *srcPtr, Tcl_Obj *copyPtr)
+{
+    copyPtr->internalRep.twoPtrValue = srcPtr->internalRep.twoPtrValue;
+    copyPtr->typePtr = treeItemObjType.objTypePtr;
+}
+
+/* + SetTreeItemObj --
+ *	Cache the item an identifier resolved to in its internal rep.
+ *	The string rep must be valid.
+ */
+static void SetTreeItemObj(Tcl_Obj *objPtr, Treeview *tv, TreeItem *item)
+{
+    const Tcl_ObjType *typePtr = objPtr->typePtr;
+
+    if ((typePtr != NULL) && (typePtr->freeIntRepProc != NULL)) {
+	typePtr->freeIntRepProc(objPtr);
+    }
+    objPtr->internalRep.twoPtrValue.ptr1 = item;
+    objPtr->internalRep.twoPtrValue.ptr2 = (void *) (size_t) tv->tree.itemEpoch;
+    objPtr->typePtr = treeItemObjType.objTypePtr;
+}
+
+TCL_DECLARE_MUTEX(itemEpochMutex)
+
+/* + NewItemEpoch --
+ *	Returns a new item epoch, distinct from all others in the process.
+ */
+static size_t NewItemEpoch(void)
+{
+    static size_t lastEpoch = 0;
+    size_t epoch;
+
+    Tcl_MutexLock(&itemEpochMutex);
+    epoch = ++lastEpoch;
+    Tcl_MutexUnlock(&itemEpochMutex);
+    return epoch;
+}
+
 /* + FindItem --
  *	Locates the item with the specified identifier in the tree.
  *	If there is no such item, leaves an error message in interp.
@@ -710,16 +848,26 @@ static TreeColumn *FindColumn(
 static TreeItem *FindItem(
     Tcl_Interp *interp, Treeview *tv, Tcl_Obj *itemNameObj)
 {
-    const char *itemName = Tcl_GetString(itemNameObj);
-    Tcl_HashEntry *entryPtr =  Tcl_FindHashEntry(&tv->tree.items, itemName);
+    const char *itemName;
+    Tcl_HashEntry *entryPtr;
+    TreeItem *item;
+
+    if (itemNameObj->typePtr == treeItemObjType.objTypePtr
+	    && GET_ITEMEPOCH(itemNameObj) == tv->tree.itemEpoch) {
+	return GET_TREEITEM(itemNameObj);
+    }
 
+    itemName = Tcl_GetString(itemNameObj);
+    entryPtr = Tcl_FindHashEntry(&tv->tree.items, itemName);
     if (!entryPtr) {
 	Tcl_SetObjResult(interp, Tcl_ObjPrintf(
 		"Item %s not found", itemName));
 	Tcl_SetErrorCode(interp, "TTK", "TREE", "ITEM", NULL);
 	return 0;
     }
-    return (TreeItem *)Tcl_GetHashValue(entryPtr);
+    item = (TreeItem *)Tcl_GetHashValue(entryPtr);
+    SetTreeItemObj(itemNameObj, tv, item);
+    return item;
 }
 
 /* + GetItemListFromObj --
@@ -761,12 +909,18 @@ static const char *ItemName(Treeview *tv, TreeItem *item)
 }
 
 /* + ItemID --
- *	Returns a fresh Tcl_Obj * (refcount 0) holding the
- *	item identifier of the specified item.
+ *	Returns a Tcl_Obj * holding the item identifier of the specified
+ *	item.  The object is shared with the item and already resolved
+ *	to it, see FindItem; callers must not modify it.
  */
 static Tcl_Obj *ItemID(Treeview *tv, TreeItem *item)
 {
-    return Tcl_NewStringObj(ItemName(tv, item), -1);
+    if (!item->idObj) {
+	item->idObj = Tcl_NewStringObj(ItemName(tv, item), -1);
+	Tcl_IncrRefCount(item->idObj);
+	SetTreeItemObj(item->idObj, tv, item);
+    }
+    return item->idObj;
 }
 
 /*------------------------------------------------------------------------
@@ -1289,6 +1443,10 @@ static void TreeviewInitialize(Tcl_Interp *interp, void *recordPtr)
     tv->tree.titleRows = 0;
     tv->tree.totalRows = 0;
     tv->tree.rowPosNeedsUpdate = 1;
+    tv->tree.rowIndex = tv->tree.itemOrder = NULL;
+    tv->tree.nRowIndex = tv->tree.rowIndexSize = 0;
+    tv->tree.validItems = 0;
+    tv->tree.validVisible = 0;
     tv->tree.striped = 0;
     tv->tree.columns = NULL;
     tv->tree.displayColumns = NULL;
@@ -1305,10 +1463,20 @@ static void TreeviewInitialize(Tcl_Interp *interp, void *recordPtr)
 	tv->tree.headingOptionTable, tv->core.tkwin);
 
     Tcl_InitHashTable(&tv->tree.items, TCL_STRING_KEYS);
+    tv->tree.itemEpoch = NewItemEpoch();
     tv->tree.serial = 0;
 
     tv->tree.focus = tv->tree.endPtr = 0;
 
+    Tcl_InitHashTable(&tv->tree.virtualTable, TCL_ONE_WORD_KEYS);
+    tv->tree.virtualFirstRow = 0;
+    tv->tree.lruFirst = tv->tree.lruLast = NULL;
+    tv->tree.fetchPending = 0;
+
+    tv->tree.damagedRows = NULL;
+    tv->tree.damagedRowsSize = tv->tree.nDamagedRows = 0;
+    tv->tree.damagePending = 0;
+
     /* Create root item "":
      */
     tv->tree.root = NewItem();
@@ -1352,6 +1520,21 @@ static void TreeviewCleanup(void *recordPtr)
 
     foreachHashEntry(&tv->tree.items, FreeItemCB);
     Tcl_DeleteHashTable(&tv->tree.items);
+    FlushVirtualRows(tv, 0, -1);
+    Tcl_DeleteHashTable(&tv->tree.virtualTable);
+    if (tv->tree.fetchPending) {
+	Tcl_CancelIdleCall(FetchVirtualRows, tv);
+    }
+    if (tv->tree.damagePending) {
+	TkCancelRedraw(RedrawDamagedRows, tv);
+    }
+    if (tv->tree.damagedRows) {
+	ckfree(tv->tree.damagedRows);
+    }
+    if (tv->tree.rowIndex) {
+	ckfree(tv->tree.rowIndex);
+	ckfree(tv->tree.itemOrder);
+    }
 
     TtkFreeScrollHandle(tv->tree.xscrollHandle);
     TtkFreeScrollHandle(tv->tree.yscrollHandle);
@@ -1395,6 +1578,23 @@ TreeviewConfigure(Tcl_Interp *interp, void *recordPtr, int mask)
 	Tcl_SetErrorCode(interp, "TTK", "TREE", "TITLEITEMS", NULL);
 	return TCL_ERROR;
     }
+    if (mask & VIRTUAL_CHANGED) {
+	/*
+	 * Row positions are ints; the virtual rows follow the real ones.
+	 */
+
+	if (tv->tree.rowPosNeedsUpdate) {
+	    UpdatePositionTree(tv);
+	}
+	if (tv->tree.virtualRows < 0 || tv->tree.virtualRows
+		> (Tcl_Size)INT_MAX - tv->tree.virtualFirstRow) {
+	    Tcl_SetObjResult(interp, Tcl_ObjPrintf(
+		    "\"%" TCL_SIZE_MODIFIER "d\" is out of range",
+		    tv->tree.virtualRows));
+	    Tcl_SetErrorCode(interp, "TTK", "TREE", "VIRTUALROWS", NULL);
+	    return TCL_ERROR;
+	}
+    }
     if (mask & SCROLLCMD_CHANGED) {
 	TtkScrollbarUpdateRequired(tv->tree.xscrollHandle);
 	TtkScrollbarUpdateRequired(tv->tree.yscrollHandle);
@@ -1409,9 +1609,13 @@ TreeviewConfigure(Tcl_Interp *interp, void *recordPtr, int mask)
 	return TCL_ERROR;
     }
 
-    tv->tree.rowPosNeedsUpdate = 1;
+    InvalidatePositions(tv, NULL);
     tv->tree.showFlags = showFlags;
 
+    if (mask & VIRTUAL_CHANGED) {
+	FlushVirtualRows(tv, 0, -1);
+    }
+
     if (mask & (SHOW_CHANGED | DCOLUMNS_CHANGED)) {
 	RecomputeSlack(tv);
     }
@@ -1499,8 +1703,12 @@ static int ConfigureItem(
 	if (item->imagespec) { TtkFreeImageSpec(item->imagespec); }
 	item->imagespec = newImageSpec;
     }
-    tv->tree.rowPosNeedsUpdate = 1;
-    TtkRedisplayWidget(&tv->core);
+    if (mask & ITEM_OPTION_LAYOUT_CHANGED) {
+	InvalidatePositions(tv, item);
+	TtkRedisplayWidget(&tv->core);
+    } else {
+	RedisplayItem(tv, item);
+    }
     return TCL_OK;
 
 error:
@@ -1600,57 +1808,171 @@ error:
  * +++ Geometry routines.
  */
 
-/* + UpdatePositionItem --
- *	Update position data for all visible items.
+/* + ChildrenHidden --
+ *	Are the children of an item hidden, either because the item
+ *	is closed or because the item itself is not displayed?
+ *	The position data of the item must be up to date.
  */
-static void UpdatePositionItem(
-    Treeview *tv, TreeItem *item, int hidden,
-    int *rowPos, int *itemPos, int *visiblePos)
+static int ChildrenHidden(Treeview *tv, TreeItem *item)
 {
-    TreeItem *child = item->children;
-    item->itemPos = *itemPos;
-    *itemPos += 1;
+    if (!(item->state & TTK_STATE_OPEN)) {
+	return 1;
+    }
+    if (item == tv->tree.root) {
+	return item->hidden;
+    }
+    return item->rowPos < 0;
+}
+
+/* + InvalidatePositions --
+ *	Mark the position data of an item and of all items following it
+ *	in preorder as out of date, or of all items if item is NULL.
+ *	Must be called before the tree is changed at item.
+ *
+ *	Position data is kept for a prefix of the items in preorder:
+ *	the first validItems entries of itemOrder, and the first
+ *	validVisible entries of rowIndex.  An item whose itemPos is
+ *	outside this prefix may have stale data, but then the prefix
+ *	already ends at or before its actual position, so the minimum
+ *	taken below is always safe.
+ */
+static void InvalidatePositions(Treeview *tv, TreeItem *item)
+{
+    int pos = (item && item->itemPos > 0) ? item->itemPos : 0;
+    Tcl_Size lo = 0, hi = tv->tree.validVisible;
 
-    if (item->hidden) {
-	hidden = 1;
+    tv->tree.rowPosNeedsUpdate = 1;
+    if (pos >= tv->tree.validItems) {
+	return;
     }
+    tv->tree.validItems = pos;
 
-    if (hidden) {
-	item->rowPos = -1;
-	item->visiblePos = -1;
-    } else {
-	item->rowPos = *rowPos;
-	item->visiblePos = *visiblePos;
-	if (*visiblePos == tv->tree.nTitleItems) {
-	    tv->tree.titleRows = *rowPos;
+    /* Visible items keep their order in preorder, so the valid part
+     * of the row index is found by binary search on itemPos.
+     */
+    while (lo < hi) {
+	Tcl_Size mid = lo + (hi - lo) / 2;
+	if (tv->tree.rowIndex[mid]->itemPos < pos) {
+	    lo = mid + 1;
+	} else {
+	    hi = mid;
 	}
-
-	*visiblePos += 1;
-	*rowPos += item->height;
     }
+    tv->tree.validVisible = lo;
+}
 
-    if (!(item->state & TTK_STATE_OPEN)) {
-	hidden = 1;
+/* + InvalidateInsertion --
+ *	Like InvalidatePositions, for an item about to be inserted
+ *	into parent after prev, or as its first child if prev is NULL
+ *	(the arguments of InsertItem).  Only the items that will follow
+ *	it in preorder are affected, so appending to the end of the tree
+ *	keeps all existing position data.
+ */
+static void InvalidateInsertion(
+    Treeview *tv, TreeItem *parent, TreeItem *prev)
+{
+    TreeItem *next = prev ? prev->next : parent->children;
+
+    while (!next && parent) {
+	next = parent->next;
+	parent = parent->parent;
     }
-    while (child) {
-	UpdatePositionItem(tv, child, hidden, rowPos, itemPos, visiblePos);
-	child = child->next;
+    if (next) {
+	InvalidatePositions(tv, next);
+    } else {
+	tv->tree.rowPosNeedsUpdate = 1;
     }
 }
 
 /* + UpdatePositionTree --
- *	Update position data for all visible items.
+ *	Update position data for all items after the valid prefix,
+ *	and the row index along with it.  Appending items to the end
+ *	of the tree thus only costs the new items.
  */
 static void UpdatePositionTree(Treeview *tv)
 {
+    TreeItem *root = tv->tree.root, *item;
+    Tcl_Size size = tv->tree.items.numEntries;
+    int itemPos = tv->tree.validItems;
+    int visiblePos = tv->tree.validVisible;
+    int rowPos = 0;
+
+    if (size > tv->tree.rowIndexSize) {
+	tv->tree.rowIndexSize = size + size / 2;
+	tv->tree.rowIndex = (TreeItem **)ckrealloc(tv->tree.rowIndex,
+		tv->tree.rowIndexSize * sizeof(TreeItem *));
+	tv->tree.itemOrder = (TreeItem **)ckrealloc(tv->tree.itemOrder,
+		tv->tree.rowIndexSize * sizeof(TreeItem *));
+    }
+
     /* -1 for the invisible root */
-    int rowPos = -1, itemPos = -1, visiblePos = -1;
-    tv->tree.titleRows = 0;
-    UpdatePositionItem(tv, tv->tree.root, 0, &rowPos, &itemPos, &visiblePos);
+    root->itemPos = root->visiblePos = root->rowPos = -1;
+    if (visiblePos > 0) {
+	item = tv->tree.rowIndex[visiblePos - 1];
+	rowPos = item->rowPos + item->height;
+    }
+    if (visiblePos <= tv->tree.nTitleItems) {
+	tv->tree.titleRows = 0;
+    }
+
+    item = itemPos > 0 ? NextPreorder(tv->tree.itemOrder[itemPos - 1])
+	    : root->children;
+    for (; item; item = NextPreorder(item)) {
+	item->itemPos = itemPos;
+	tv->tree.itemOrder[itemPos++] = item;
+	if (item->hidden || ChildrenHidden(tv, item->parent)) {
+	    item->rowPos = -1;
+	    item->visiblePos = -1;
+	} else {
+	    item->rowPos = rowPos;
+	    item->visiblePos = visiblePos;
+	    if (visiblePos == tv->tree.nTitleItems) {
+		tv->tree.titleRows = rowPos;
+	    }
+	    tv->tree.rowIndex[visiblePos++] = item;
+	    rowPos += item->height;
+	}
+    }
+
+    tv->tree.virtualFirstRow = rowPos;
+    if (tv->tree.rowCommandObj) {
+	/*
+	 * Rows inserted after -virtualrows was checked may leave less room;
+	 * virtual rows beyond INT_MAX are not shown.
+	 */
+
+	if (tv->tree.virtualRows > (Tcl_Size)INT_MAX - rowPos) {
+	    rowPos = INT_MAX;
+	} else {
+	    rowPos += (int)tv->tree.virtualRows;
+	}
+    }
     tv->tree.totalRows = rowPos;
+    tv->tree.nRowIndex = tv->tree.validVisible = visiblePos;
+    tv->tree.validItems = itemPos;
     tv->tree.rowPosNeedsUpdate = 0;
 }
 
+/* + SearchRowIndex --
+ *	Returns the index in the row index of the first visible item
+ *	starting at or below the specified row, or nRowIndex if none.
+ *	rowPos increases along the row index, so this is a binary search.
+ */
+static Tcl_Size SearchRowIndex(Treeview *tv, int row)
+{
+    Tcl_Size lo = 0, hi = tv->tree.nRowIndex;
+
+    while (lo < hi) {
+	Tcl_Size mid = lo + (hi - lo) / 2;
+	if (tv->tree.rowIndex[mid]->rowPos < row) {
+	    lo = mid + 1;
+	} else {
+	    hi = mid;
+	}
+    }
+    return lo;
+}
+
 /* + IdentifyItem --
  *	Locate the item at the specified y position, if any.
  */
@@ -1659,7 +1981,8 @@ static TreeItem *IdentifyItem(Treeview *tv, int y)
     TreeItem *item;
     int rowHeight = tv->tree.rowHeight;
     int ypos = tv->tree.treeArea.y;
-    int nextRow, row;
+    Tcl_Size i;
+    int row;
     if (y < ypos) {
 	return NULL;
     }
@@ -1670,11 +1993,19 @@ static TreeItem *IdentifyItem(Treeview *tv, int y)
     if (row >= tv->tree.titleRows) {
 	row += tv->tree.yscroll.first;
     }
-    for (item = tv->tree.root->children; item; item = NextPreorder(item)) {
-	nextRow = item->rowPos + item->height;
-	if (item->rowPos <= row && row < nextRow) break;
+
+    /* The item is the last one starting at or above row, if it
+     * extends down to row.
+     */
+    i = SearchRowIndex(tv, row + 1);
+    if (i == 0) {
+	return NULL;
     }
-    return item;
+    item = tv->tree.rowIndex[i - 1];
+    if (row < item->rowPos + item->height) {
+	return item;
+    }
+    return NULL;
 }
 
 /* + IdentifyDisplayColumn --
@@ -1999,8 +2330,13 @@ static void TreeviewDoLayout(void *clientData)
     }
 
     visibleRows = tv->tree.treeArea.height / tv->tree.rowHeight;
-    tv->tree.root->state |= TTK_STATE_OPEN;
-    UpdatePositionTree(tv);
+    if (!(tv->tree.root->state & TTK_STATE_OPEN)) {
+	tv->tree.root->state |= TTK_STATE_OPEN;
+	InvalidatePositions(tv, NULL);
+    }
+    if (tv->tree.rowPosNeedsUpdate) {
+	UpdatePositionTree(tv);
+    }
     first = tv->tree.yscroll.first;
     last = tv->tree.yscroll.first + visibleRows - tv->tree.titleRows;
     total = tv->tree.totalRows - tv->tree.titleRows;
@@ -2185,8 +2521,51 @@ static void PrepareCells(
     }
 }
 
+/* + CellParcel --
+ *	Compute the parcel of a data cell and advance *xPtr and *xPadPtr
+ *	to the next column.
+ */
+static Ttk_Box CellParcel(
+    Treeview *tv, TreeColumn *column, int *xPtr, int *xPadPtr,
+    int y, int height)
+{
+    int parcelWidth = column->separator ?
+	    column->width - tv->tree.colSeparatorWidth : column->width;
+    Ttk_Box parcel = Ttk_MakeBox(*xPtr + *xPadPtr, y, parcelWidth, height);
+
+    *xPadPtr = column->separator ? tv->tree.colSeparatorWidth/2 : 0;
+    *xPtr += column->width;
+    return parcel;
+}
+
+/* + SameTagSet --
+ *	Returns: nonzero if two cell tag sets hold the same tags.
+ */
+static int SameTagSet(Ttk_TagSet tagset1, Ttk_TagSet tagset2)
+{
+    Tcl_Size i;
+
+    if (tagset1 == tagset2) {
+	return 1;
+    }
+    if (!tagset1 || !tagset2 || tagset1->nTags != tagset2->nTags) {
+	return 0;
+    }
+    for (i = 0; i < tagset1->nTags; ++i) {
+	if (tagset1->tags[i] != tagset2->tags[i]) {
+	    return 0;
+	}
+    }
+    return 1;
+}
+
 /* + DrawCells --
  *	Draw data cells for specified item.
+ *
+ *	Adjacent cells with the same selection and cell tags are drawn
+ *	as one run: their display options are resolved once and their
+ *	backgrounds are merged into a single rectangle where the cells
+ *	touch.  Cells beyond the right edge of the tree area are skipped.
  */
 static void DrawCells(
     Treeview *tv, TreeItem *item,
@@ -2201,8 +2580,9 @@ static void DrawCells(
     DisplayItem displayItemLocal;
     DisplayItem displayItemCell, displayItemCellSel;
     int rowHeight = tv->tree.rowHeight * item->height;
+    int right = tv->tree.treeArea.x + tv->tree.treeArea.width;
     int xPad = 0, defaultPadding = 1;
-    Tcl_Size i;
+    Tcl_Size i, j, k;
 
     /* Adjust if the tree column has a separator */
     if (tv->tree.showFlags & SHOW_TREE && tv->tree.column0.separator) {
@@ -2224,21 +2604,19 @@ static void DrawCells(
 	defaultPadding = 0;
     }
 
-    for (i = 1; i < tv->tree.nDisplayColumns; ++i) {
+    for (i = 1; i < tv->tree.nDisplayColumns; i = j) {
 	TreeColumn *column = tv->tree.displayColumns[i];
-	int parcelX = x + xPad;
-	int parcelWidth = column->separator ?
-		column->width - tv->tree.colSeparatorWidth : column->width;
-	Ttk_Box parcel = Ttk_MakeBox(parcelX, y, parcelWidth, rowHeight);
+	int runX = x, runXPad = xPad;
+	Ttk_Box parcel = CellParcel(tv, column, &x, &xPad, y, rowHeight);
 	DisplayItem *displayItemUsed = &displayItemCell;
 	Ttk_State stateCell = state;
 	Tk_Anchor textAnchor, imageAnchor;
-	xPad = column->separator ? tv->tree.colSeparatorWidth/2 : 0;
 
-	x += column->width;
+	j = i + 1;
 	if (title  && i >= tv->tree.nTitleColumns) break;
 	if (!title && i <  tv->tree.nTitleColumns) continue;
 	if (!title && x <  tv->tree.titleWidth) continue;
+	if (parcel.x >= right) break;
 
 	if (column->selected) {
 	    displayItemUsed = &displayItemCellSel;
@@ -2255,29 +2633,63 @@ static void DrawCells(
 		    displayItemUsed);
 	}
 
-	displayItemUsed->textObj = column->data;
-	displayItemUsed->anchorObj = column->anchorObj;/* <<NOTE-ANCHOR>> */
-	Tk_GetAnchorFromObj(NULL, column->anchorObj, &textAnchor);
-
 	imageAnchor = DEFAULT_IMAGEANCHOR;
 	if (displayItemUsed->imageAnchorObj) {
 	    Tk_GetAnchorFromObj(NULL, displayItemUsed->imageAnchorObj,
 		    &imageAnchor);
 	}
-	/* displayItem was used to draw the full item backgound.
-	   Redraw cell background if needed. */
+
+	/* Extend the run over following cells that resolve to the same
+	 * display options.  displayItem was used to draw the full item
+	 * background; redraw cell backgrounds if needed.
+	 */
+	for (; j < tv->tree.nDisplayColumns; ++j) {
+	    TreeColumn *next = tv->tree.displayColumns[j];
+	    int nextX = x, nextXPad = xPad;
+	    Ttk_Box nextParcel =
+		    CellParcel(tv, next, &nextX, &nextXPad, y, rowHeight);
+
+	    if ((title && j >= tv->tree.nTitleColumns)
+		    || nextParcel.x >= right
+		    || next->selected != column->selected
+		    || !SameTagSet(next->tagset, column->tagset)) {
+		break;
+	    }
+	    if (displayItemUsed != &displayItemCell) {
+		if (nextParcel.x == parcel.x + parcel.width) {
+		    parcel.width += nextParcel.width;
+		} else {
+		    DisplayLayout(tv->tree.rowLayout, displayItemUsed,
+			    stateCell, parcel, d);
+		    parcel = nextParcel;
+		}
+	    }
+	    x = nextX;
+	    xPad = nextXPad;
+	}
 	if (displayItemUsed != &displayItemCell) {
 	    DisplayLayout(tv->tree.rowLayout, displayItemUsed, stateCell,
 		    parcel, d);
 	}
 
-	if (defaultPadding && displayItemUsed->paddingObj == NULL) {
-	    /* If no explicit padding was asked for, add some default. */
-	    parcel = Ttk_PadBox(parcel, cellPadding);
-	}
+	/* Draw cell contents:
+	 */
+	for (k = i; k < j; ++k) {
+	    column = tv->tree.displayColumns[k];
+	    parcel = CellParcel(tv, column, &runX, &runXPad, y, rowHeight);
 
-	DisplayLayoutTree(imageAnchor, textAnchor,
-		layout, displayItemUsed, state, parcel, d);
+	    displayItemUsed->textObj = column->data;
+	    displayItemUsed->anchorObj = column->anchorObj;/* <<NOTE-ANCHOR>> */
+	    Tk_GetAnchorFromObj(NULL, column->anchorObj, &textAnchor);
+
+	    if (defaultPadding && displayItemUsed->paddingObj == NULL) {
+		/* If no explicit padding was asked for, add some default. */
+		parcel = Ttk_PadBox(parcel, cellPadding);
+	    }
+
+	    DisplayLayoutTree(imageAnchor, textAnchor,
+		    layout, displayItemUsed, state, parcel, d);
+	}
     }
 }
 
@@ -2397,93 +2809,373 @@ static void DrawItem(
     }
 }
 
-/* + DrawSubtree --
- *	Draw an item and all of its (viewable) descendants.
+/*------------------------------------------------------------------------
+ * +++ Virtual rows.
+ *
+ * With a -rowcommand, the treeview displays -virtualrows additional
+ * rows after the items in the tree.  Only the rows in view are ever
+ * materialized: the -rowcommand is called with the row index appended
+ * and returns a {text values tags} list, as for [$tv insertrows].
+ * Materialized rows are kept on a least recently displayed list and
+ * dropped when there are more than a few screenfuls of them, so memory
+ * use is proportional to the viewport rather than to -virtualrows.
+ *
+ * The -rowcommand is never called while drawing: rows that are not yet
+ * available are left blank and fetched by an idle handler, which then
+ * redisplays the widget.
  */
 
-static void DrawForest(	/* forward */
-    Treeview *tv, TreeItem *item, Drawable d, int depth);
+#define VIRTUAL_CACHE_MIN	256	/* Minimum #rows kept materialized */
 
-static void DrawSubtree(
-    Treeview *tv, TreeItem *item, Drawable d, int depth)
+/* + SetRowFields --
+ *	Set the -text, -values and -tags options of an item
+ *	from the first nFields elements of a {text values tags} list.
+ */
+static int SetRowFields(
+    Tcl_Interp *interp, Treeview *tv, TreeItem *item,
+    Tcl_Size nFields, Tcl_Obj *const fields[])
+{
+    if (nFields > 1) {
+	Tcl_Size unused;
+	if (Tcl_ListObjLength(interp, fields[1], &unused) != TCL_OK) {
+	    return TCL_ERROR;
+	}
+    }
+    if (nFields > 2) {
+	Ttk_TagSet tagset = Ttk_GetTagSetFromObj(
+		interp, tv->tree.tagTable, fields[2]);
+	if (!tagset) {
+	    return TCL_ERROR;
+	}
+	Ttk_FreeTagSet(item->tagset);
+	item->tagset = tagset;
+	Tcl_IncrRefCount(fields[2]);
+	if (item->tagsObj) { Tcl_DecrRefCount(item->tagsObj); }
+	item->tagsObj = fields[2];
+    }
+    if (nFields > 1) {
+	Tcl_IncrRefCount(fields[1]);
+	if (item->valuesObj) { Tcl_DecrRefCount(item->valuesObj); }
+	item->valuesObj = fields[1];
+    }
+    if (nFields > 0) {
+	Tcl_IncrRefCount(fields[0]);
+	if (item->textObj) { Tcl_DecrRefCount(item->textObj); }
+	item->textObj = fields[0];
+    }
+    return TCL_OK;
+}
+
+/* + VirtualRange --
+ *	Compute the range of virtual rows in view.
+ *	Returns 0 if there are none.
+ */
+static int VirtualRange(Treeview *tv, Tcl_WideInt *firstPtr, Tcl_WideInt *lastPtr)
 {
-    int dispRow = DisplayRow(item->rowPos, tv);
-    if (dispRow >= 0) {
-	DrawItem(tv, item, d, depth);
+    Tcl_WideInt firstRow, lastRow;
+
+    if (!tv->tree.rowCommandObj || tv->tree.rowHeight <= 0) {
+	return 0;
     }
+    firstRow = tv->tree.titleRows + tv->tree.yscroll.first;
+    lastRow = firstRow + tv->tree.treeArea.height / tv->tree.rowHeight
+	    - tv->tree.titleRows;
 
-    if (item->state & TTK_STATE_OPEN) {
-	DrawForest(tv, item->children, d, depth + 1);
+    *firstPtr = firstRow - tv->tree.virtualFirstRow;
+    if (*firstPtr < 0) {
+	*firstPtr = 0;
     }
+    *lastPtr = lastRow - tv->tree.virtualFirstRow;
+    if (*lastPtr >= tv->tree.virtualRows) {
+	*lastPtr = tv->tree.virtualRows - 1;
+    }
+    return *firstPtr <= *lastPtr;
 }
 
-/* + DrawForest --
- *	Draw a sequence of items and their visible descendants.
+/* + UnlinkVirtualRow --
+ *	Remove a virtual row from the LRU list.
  */
-static void DrawForest(
-    Treeview *tv, TreeItem *item, Drawable d, int depth)
+static void UnlinkVirtualRow(Treeview *tv, VirtualRow *row)
 {
-    while (item) {
-	DrawSubtree(tv, item, d, depth);
-	item = item->next;
+    if (row->prev) {
+	row->prev->next = row->next;
+    } else {
+	tv->tree.lruFirst = row->next;
     }
+    if (row->next) {
+	row->next->prev = row->prev;
+    } else {
+	tv->tree.lruLast = row->prev;
+    }
+    row->prev = row->next = NULL;
 }
 
-/* + DrawTreeArea --
- *     Draw the tree area including the headings, if any
+/* + TouchVirtualRow --
+ *	Move a virtual row to the front of the LRU list.
  */
-static void DrawTreeArea(Treeview *tv, Drawable d) {
-    if (tv->tree.showFlags & SHOW_HEADINGS) {
-	DrawHeadings(tv, d);
+static void TouchVirtualRow(Treeview *tv, VirtualRow *row)
+{
+    if (tv->tree.lruFirst == row) {
+	return;
     }
-    DrawForest(tv, tv->tree.root->children, d, 0);
-    DrawSeparators(tv, d);
+    if (row->prev || row->next || tv->tree.lruLast == row) {
+	UnlinkVirtualRow(tv, row);
+    }
+    row->next = tv->tree.lruFirst;
+    if (row->next) {
+	row->next->prev = row;
+    } else {
+	tv->tree.lruLast = row;
+    }
+    tv->tree.lruFirst = row;
 }
 
-/* + TreeviewDisplay --
- *	Display() widget hook.  Draw the widget contents.
+static void FreeVirtualRow(Treeview *tv, VirtualRow *row)
+{
+    UnlinkVirtualRow(tv, row);
+    Tcl_DeleteHashEntry(row->entryPtr);
+    FreeItem(row->item);
+    ckfree(row);
+}
+
+/* + FlushVirtualRows --
+ *	Discard materialized virtual rows first through last,
+ *	or first through the end if last < 0.
  */
-static void TreeviewDisplay(void *clientData, Drawable d)
+static void FlushVirtualRows(
+    Treeview *tv, Tcl_WideInt first, Tcl_WideInt last)
+{
+    VirtualRow *row = tv->tree.lruFirst, *next;
+
+    for (; row; row = next) {
+	Tcl_WideInt index = (Tcl_WideInt)(intptr_t)
+		Tcl_GetHashKey(&tv->tree.virtualTable, row->entryPtr);
+	next = row->next;
+	if (index >= first && (last < 0 || index <= last)) {
+	    FreeVirtualRow(tv, row);
+	}
+    }
+}
+
+/* + FetchVirtualRows --
+ *	Idle handler: call the -rowcommand for each virtual row in view
+ *	that is not materialized yet, then trim the LRU list.
+ */
+static void FetchVirtualRows(void *clientData)
 {
     Treeview *tv = (Treeview *)clientData;
-    Tk_Window tkwin = tv->core.tkwin;
-    int width, height, winWidth, winHeight;
+    Tcl_Interp *interp = tv->core.interp;
+    Tcl_WideInt first, last, index, capacity;
+    int fetched = 0;
 
-    /* Draw the general layout of the treeview widget */
-    Ttk_DrawLayout(tv->core.layout, tv->core.state, d);
+    tv->tree.fetchPending = 0;
+    if (!VirtualRange(tv, &first, &last)) {
+	return;
+    }
 
-    /* When the tree area does not fit in the available space, there is a
-     * risk that it will be drawn over other areas of the layout.
-     */
+    Tcl_Preserve(tv);
+    for (index = first; index <= last; ++index) {
+	Tcl_HashEntry *entryPtr;
+	Tcl_Obj *cmdObj, **fields;
+	Tcl_Size nFields;
+	VirtualRow *row;
+	TreeItem *item;
+	int isNew, code;
 
-    winWidth = Tk_Width(tkwin);
-    winHeight = Tk_Height(tkwin);
-    width = tv->tree.treeArea.width;
-    height = tv->tree.headingArea.height + tv->tree.treeArea.height;
+	if (tv->core.flags & WIDGET_DESTROYED
+		|| !tv->tree.rowCommandObj || index >= tv->tree.virtualRows) {
+	    break;
+	}
+	if (Tcl_FindHashEntry(&tv->tree.virtualTable, (char *)(intptr_t)index)) {
+	    continue;
+	}
 
-    if ((width == winWidth && height == winHeight)
-      || (tv->tree.treeArea.height % tv->tree.rowHeight == 0
-	&& TreeWidth(tv) <= width)) {
-	/* No protection is needed; either the tree area fills the entire
-	 * widget, or everything fits within the available area.
+	cmdObj = Tcl_DuplicateObj(tv->tree.rowCommandObj);
+	Tcl_IncrRefCount(cmdObj);
+	Tcl_ListObjAppendElement(NULL, cmdObj, Tcl_NewWideIntObj(index));
+	code = Tcl_EvalObjEx(interp, cmdObj, TCL_EVAL_GLOBAL);
+	Tcl_DecrRefCount(cmdObj);
+	if (tv->core.flags & WIDGET_DESTROYED) {
+	    break;
+	}
+
+	/* The -rowcommand may have flushed or materialized rows itself:
 	 */
-	DrawTreeArea(tv, d);
-    } else {
-	/* The tree area needs to be clipped
+	entryPtr = Tcl_CreateHashEntry(
+		&tv->tree.virtualTable, (char *)(intptr_t)index, &isNew);
+	if (!isNew) {
+	    continue;
+	}
+	item = NewItem();
+	Tk_InitOptions(interp, item, tv->tree.itemOptionTable, tv->core.tkwin);
+	item->tagset = Ttk_GetTagSetFromObj(NULL, tv->tree.tagTable, NULL);
+
+	/* On error, leave the row blank rather than trying again
+	 * on every redisplay.
 	 */
+	if (code == TCL_OK) {
+	    Tcl_Obj *resultObj = Tcl_GetObjResult(interp);
+	    Tcl_IncrRefCount(resultObj);
+	    if (Tcl_ListObjGetElements(interp, resultObj, &nFields, &fields)
+		    != TCL_OK) {
+		code = TCL_ERROR;
+	    } else if (nFields > 3) {
+		Tcl_SetObjResult(interp, Tcl_ObjPrintf(
+		    "Bad row \"%s\": must be a list of text, values and tags",
+		    Tcl_GetString(resultObj)));
+		Tcl_SetErrorCode(interp, "TTK", "TREE", "ROW", NULL);
+		code = TCL_ERROR;
+	    } else {
+		code = SetRowFields(interp, tv, item, nFields, fields);
+	    }
+	    Tcl_DecrRefCount(resultObj);
+	}
+	if (code != TCL_OK) {
+	    Tcl_AddErrorInfo(interp, "\n    (treeview -rowcommand)");
+	    Tcl_BackgroundException(interp, code);
+	}
+	Tcl_ResetResult(interp);
 
-	int x, y;
+	row = (VirtualRow *)ckalloc(sizeof(VirtualRow));
+	row->item = item;
+	row->entryPtr = entryPtr;
+	row->prev = row->next = NULL;
+	Tcl_SetHashValue(entryPtr, row);
+	TouchVirtualRow(tv, row);
+	fetched = 1;
+    }
 
-	x = tv->tree.treeArea.x;
-	if (tv->tree.showFlags & SHOW_HEADINGS) {
-	    y = tv->tree.headingArea.y;
-	} else {
-	    y = tv->tree.treeArea.y;
+    if (!(tv->core.flags & WIDGET_DESTROYED)) {
+	capacity = 4 * (last - first + 1);
+	if (capacity < VIRTUAL_CACHE_MIN) {
+	    capacity = VIRTUAL_CACHE_MIN;
 	}
+	while (tv->tree.virtualTable.numEntries > capacity) {
+	    FreeVirtualRow(tv, tv->tree.lruLast);
+	}
+	if (fetched) {
+	    TtkRedisplayWidget(&tv->core);
+	}
+    }
+    Tcl_Release(tv);
+}
 
-#ifndef TK_NO_DOUBLE_BUFFERING
-	Drawable p;
-	XGCValues gcValues;
+/* + DrawVirtualRows --
+ *	Draw the materialized virtual rows in view,
+ *	and schedule fetching the others.
+ */
+static void DrawVirtualRows(Treeview *tv, Drawable d)
+{
+    Tcl_WideInt first, last, index;
+    int missing = 0;
+
+    if (!VirtualRange(tv, &first, &last)) {
+	return;
+    }
+    for (index = first; index <= last; ++index) {
+	Tcl_HashEntry *entryPtr = Tcl_FindHashEntry(
+		&tv->tree.virtualTable, (char *)(intptr_t)index);
+	VirtualRow *row;
+
+	if (!entryPtr) {
+	    missing = 1;
+	    continue;
+	}
+	row = (VirtualRow *)Tcl_GetHashValue(entryPtr);
+	row->item->rowPos = tv->tree.virtualFirstRow + (int)index;
+	row->item->visiblePos = (int)(tv->tree.nRowIndex + index);
+	TouchVirtualRow(tv, row);
+	DrawItem(tv, row->item, d, 0);
+    }
+    if (missing && !tv->tree.fetchPending) {
+	Tcl_DoWhenIdle(FetchVirtualRows, tv);
+	tv->tree.fetchPending = 1;
+    }
+}
+
+/* + DrawRows --
+ *	Draw the items whose first row is on screen: the title items,
+ *	and those in the scrolled part of the view.  The row index
+ *	locates the first of them, so only the visible items are visited.
+ */
+static void DrawRows(Treeview *tv, Drawable d)
+{
+    int visibleRows = tv->tree.treeArea.height / tv->tree.rowHeight
+	    - tv->tree.titleRows;
+    int firstRow = tv->tree.titleRows + tv->tree.yscroll.first;
+    Tcl_Size i;
+
+    for (i = 0; i < tv->tree.nRowIndex
+	    && tv->tree.rowIndex[i]->rowPos < tv->tree.titleRows; ++i) {
+	DrawItem(tv, tv->tree.rowIndex[i], d, ItemDepth(tv->tree.rowIndex[i]));
+    }
+    for (i = SearchRowIndex(tv, firstRow); i < tv->tree.nRowIndex
+	    && tv->tree.rowIndex[i]->rowPos <= firstRow + visibleRows; ++i) {
+	DrawItem(tv, tv->tree.rowIndex[i], d, ItemDepth(tv->tree.rowIndex[i]));
+    }
+    if (tv->tree.rowCommandObj) {
+	DrawVirtualRows(tv, d);
+    }
+}
+
+/* + DrawTreeArea --
+ *     Draw the tree area including the headings, if any
+ */
+static void DrawTreeArea(Treeview *tv, Drawable d) {
+    if (tv->tree.showFlags & SHOW_HEADINGS) {
+	DrawHeadings(tv, d);
+    }
+    DrawRows(tv, d);
+    DrawSeparators(tv, d);
+}
+
+/* + TreeviewDisplay --
+ *	Display() widget hook.  Draw the widget contents.
+ */
+static void TreeviewDisplay(void *clientData, Drawable d)
+{
+    Treeview *tv = (Treeview *)clientData;
+    Tk_Window tkwin = tv->core.tkwin;
+    int width, height, winWidth, winHeight;
+
+    /* A full redisplay covers any damaged rows */
+    ClearDamage(tv);
+
+    /* Draw the general layout of the treeview widget */
+    Ttk_DrawLayout(tv->core.layout, tv->core.state, d);
+
+    /* When the tree area does not fit in the available space, there is a
+     * risk that it will be drawn over other areas of the layout.
+     */
+
+    winWidth = Tk_Width(tkwin);
+    winHeight = Tk_Height(tkwin);
+    width = tv->tree.treeArea.width;
+    height = tv->tree.headingArea.height + tv->tree.treeArea.height;
+
+    if ((width == winWidth && height == winHeight)
+      || (tv->tree.treeArea.height % tv->tree.rowHeight == 0
+	&& TreeWidth(tv) <= width)) {
+	/* No protection is needed; either the tree area fills the entire
+	 * widget, or everything fits within the available area.
+	 */
+	DrawTreeArea(tv, d);
+    } else {
+	/* The tree area needs to be clipped
+	 */
+
+	int x, y;
+
+	x = tv->tree.treeArea.x;
+	if (tv->tree.showFlags & SHOW_HEADINGS) {
+	    y = tv->tree.headingArea.y;
+	} else {
+	    y = tv->tree.treeArea.y;
+	}
+
+#ifndef TK_NO_DOUBLE_BUFFERING
+	Drawable p;
+	XGCValues gcValues;
 	GC gc;
 
 	/* Create a temporary helper drawable */
@@ -2524,6 +3216,203 @@ static void TreeviewDisplay(void *clientData, Drawable d)
     }
 }
 
+/*------------------------------------------------------------------------
+ * +++ Partial redisplay.
+ *	A change to the contents of a single item, such as from
+ *	[$tv item] or [$tv set], only marks the item's display row
+ *	as damaged.  Unless something requests a full redisplay in
+ *	the meantime, RedrawDamagedRows() then redraws just those
+ *	rows and copies them to the window.
+ */
+
+/* + ClearDamage --
+ *	Forget all damaged rows.
+ */
+static void ClearDamage(Treeview *tv)
+{
+    if (tv->tree.nDamagedRows) {
+	memset(tv->tree.damagedRows, 0, tv->tree.damagedRowsSize);
+	tv->tree.nDamagedRows = 0;
+    }
+}
+
+/* + DisplayRowItem --
+ *	Returns the item whose first row is shown at the specified
+ *	display row, or NULL if there is none.
+ */
+static TreeItem *DisplayRowItem(Treeview *tv, int dispRow)
+{
+    int row = dispRow;
+    Tcl_Size i;
+
+    if (row >= tv->tree.titleRows) {
+	row += tv->tree.yscroll.first;
+    }
+    i = SearchRowIndex(tv, row);
+    if (i < tv->tree.nRowIndex && tv->tree.rowIndex[i]->rowPos == row) {
+	return tv->tree.rowIndex[i];
+    }
+    return NULL;
+}
+
+/* + RedrawDamagedRows --
+ *	Redraw the damaged rows.  Called as an idle handler.
+ *	Only the rows are drawn, onto a pixmap that spans the
+ *	damaged rows and the columns; the rest of the layout is
+ *	left as it is on the screen.
+ */
+static void RedrawDamagedRows(void *clientData)
+{
+    Treeview *tv = (Treeview *)clientData;
+    Tk_Window tkwin = tv->core.tkwin;
+    Ttk_Box area = tv->tree.treeArea;
+    int rowHeight = tv->tree.rowHeight;
+    int top = -1, bottom = -1, width;
+    Drawable p;
+    XGCValues gcValues;
+    GC gc;
+    int dispRow;
+
+    tv->tree.damagePending = 0;
+    if (!tv->tree.nDamagedRows
+	    || (tv->core.flags & REDISPLAY_PENDING)
+	    || !Tk_IsMapped(tkwin)) {
+	ClearDamage(tv);
+	return;
+    }
+    if (tv->tree.rowPosNeedsUpdate) {
+	ClearDamage(tv);
+	TtkRedisplayWidget(&tv->core);
+	return;
+    }
+
+    /* Find the rows to draw, clipped to the tree area.  Row
+     * backgrounds span the columns, so nothing to the right of
+     * them needs redrawing.
+     */
+    for (dispRow = 0; dispRow < tv->tree.damagedRowsSize; ++dispRow) {
+	TreeItem *item;
+	int y, height;
+
+	if (!tv->tree.damagedRows[dispRow]
+		|| (item = DisplayRowItem(tv, dispRow)) == NULL) {
+	    tv->tree.damagedRows[dispRow] = 0;
+	    continue;
+	}
+	y = area.y + dispRow * rowHeight;
+	height = rowHeight * item->height;
+	if (y + height > area.y + area.height) {
+	    height = area.y + area.height - y;
+	}
+	if (height <= 0) {
+	    tv->tree.damagedRows[dispRow] = 0;
+	    continue;
+	}
+	if (top < 0) {
+	    top = y;
+	}
+	if (y + height > bottom) {
+	    bottom = y + height;
+	}
+    }
+    width = TreeWidth(tv);
+    if (width > area.width) {
+	width = area.width;
+    }
+    if (top < 0 || width <= 0) {
+	ClearDamage(tv);
+	return;
+    }
+
+    /* Draw the damaged rows onto a helper drawable covering just
+     * them; x coordinates are kept, y is shifted by top.
+     */
+    p = Tk_GetPixmap(Tk_Display(tkwin), Tk_WindowId(tkwin),
+	    area.x + width, bottom - top, Tk_Depth(tkwin));
+    tv->tree.treeArea.y -= top;
+    for (dispRow = 0; dispRow < tv->tree.damagedRowsSize; ++dispRow) {
+	if (tv->tree.damagedRows[dispRow]) {
+	    TreeItem *item = DisplayRowItem(tv, dispRow);
+	    DrawItem(tv, item, p, ItemDepth(item));
+	}
+    }
+    DrawSeparators(tv, p);
+    tv->tree.treeArea.y += top;
+
+    /* Copy only the damaged rows to the window:
+     */
+    gcValues.function = GXcopy;
+    gcValues.graphics_exposures = False;
+    gc = Tk_GetGC(tkwin, GCFunction|GCGraphicsExposures, &gcValues);
+    for (dispRow = 0; dispRow < tv->tree.damagedRowsSize; ++dispRow) {
+	TreeItem *item;
+	int y, height;
+
+	if (!tv->tree.damagedRows[dispRow]) {
+	    continue;
+	}
+	item = DisplayRowItem(tv, dispRow);
+	y = area.y + dispRow * rowHeight;
+	height = rowHeight * item->height;
+	if (y + height > bottom) {
+	    height = bottom - y;
+	}
+	XCopyArea(Tk_Display(tkwin), p, Tk_WindowId(tkwin), gc,
+		area.x, y - top, (unsigned) width, (unsigned) height,
+		area.x, y);
+    }
+    Tk_FreeGC(Tk_Display(tkwin), gc);
+    Tk_FreePixmap(Tk_Display(tkwin), p);
+
+    ClearDamage(tv);
+}
+
+/* + RedisplayItem --
+ *	Schedule redisplay of an item whose contents, but not its
+ *	size or position, have changed.
+ */
+static void RedisplayItem(Treeview *tv, TreeItem *item)
+{
+#ifndef TK_NO_DOUBLE_BUFFERING
+    int dispRow;
+
+    if (tv->core.flags & (REDISPLAY_PENDING | WIDGET_DESTROYED)) {
+	return;
+    }
+    if (tv->tree.rowPosNeedsUpdate) {
+	TtkRedisplayWidget(&tv->core);
+	return;
+    }
+    if (item->visiblePos < 0 || item->visiblePos >= tv->tree.nRowIndex
+	    || tv->tree.rowIndex[item->visiblePos] != item) {
+	return;		/* not displayed */
+    }
+    dispRow = DisplayRow(item->rowPos, tv);
+    if (dispRow < 0) {
+	return;		/* off-screen */
+    }
+
+    if (dispRow >= tv->tree.damagedRowsSize) {
+	int size = dispRow + 1;
+	tv->tree.damagedRows = (char *)ckrealloc(tv->tree.damagedRows, size);
+	memset(tv->tree.damagedRows + tv->tree.damagedRowsSize, 0,
+		size - tv->tree.damagedRowsSize);
+	tv->tree.damagedRowsSize = size;
+    }
+    if (!tv->tree.damagedRows[dispRow]) {
+	tv->tree.damagedRows[dispRow] = 1;
+	++tv->tree.nDamagedRows;
+    }
+    if (!tv->tree.damagePending) {
+	TkScheduleRedraw(tv->core.tkwin, RedrawDamagedRows, tv);
+	tv->tree.damagePending = 1;
+    }
+#else
+    (void)item;
+    TtkRedisplayWidget(&tv->core);
+#endif
+}
+
 /*------------------------------------------------------------------------
  * +++ Utilities for widget commands
  */
@@ -2667,6 +3556,7 @@ static int TreeviewChildrenCommand(
 
 	/* Detach old children:
 	 */
+	InvalidatePositions(tv, item);
 	child = item->children;
 	while (child) {
 	    TreeItem *next = child->next;
@@ -2677,6 +3567,7 @@ static int TreeviewChildrenCommand(
 	/* Detach new children from their current locations:
 	 */
 	for (i = 0; newChildren[i]; ++i) {
+	    InvalidatePositions(tv, newChildren[i]);
 	    DetachItem(newChildren[i]);
 	}
 
@@ -2697,7 +3588,6 @@ static int TreeviewChildrenCommand(
 	}
 
 	ckfree(newChildren);
-	tv->tree.rowPosNeedsUpdate = 1;
 	TtkRedisplayWidget(&tv->core);
     }
 
@@ -3155,6 +4045,35 @@ static int TreeviewHeadingCommand(
     }
 }
 
+/* + SetItemValue --
+ *	Set the value of the specified data column of an item,
+ *	padding -values with empty strings as needed.
+ */
+static void SetItemValue(
+    Treeview *tv, TreeItem *item, Tcl_Size columnNumber, Tcl_Obj *valueObj)
+{
+    Tcl_Size length;
+
+    if (!item->valuesObj) {
+	item->valuesObj = Tcl_NewListObj(0,0);
+	Tcl_IncrRefCount(item->valuesObj);
+    }
+    item->valuesObj = unshareObj(item->valuesObj);
+
+    /* Make sure -values is fully populated:
+     */
+    Tcl_ListObjLength(NULL, item->valuesObj, &length);
+    while (length < tv->tree.nColumns) {
+	Tcl_Obj *empty = Tcl_NewStringObj("",0);
+	Tcl_ListObjAppendElement(NULL, item->valuesObj, empty);
+	++length;
+    }
+
+    /* Set value:
+     */
+    Tcl_ListObjReplace(NULL, item->valuesObj, columnNumber, 1, 1, &valueObj);
+}
+
 /* + $tv set $item ?$column ?value??
  *	Query or configure cell values
  */
@@ -3224,31 +4143,134 @@ static int TreeviewSetCommand(
 	Tcl_SetObjResult(interp, result);
 	return TCL_OK;
     } else {		/* set column */
-	Tcl_Size length;
+	SetItemValue(tv, item, columnNumber, objv[4]);
+	RedisplayItem(tv, item);
+	return TCL_OK;
+    }
+}
 
-	item->valuesObj = unshareObj(item->valuesObj);
+/* + $tv setcolumn $column $itemValueList --
+ *	Set the value of $column for each item/value pair
+ *	in $itemValueList.  All items are looked up before
+ *	anything is changed, and the widget is redisplayed once.
+ */
+static int TreeviewSetColumnCommand(
+    void *recordPtr, Tcl_Interp *interp, Tcl_Size objc, Tcl_Obj *const objv[])
+{
+    Treeview *tv = (Treeview *)recordPtr;
+    TreeColumn *column;
+    TreeItem **items;
+    Tcl_Obj **elements;
+    Tcl_Size nElements, columnNumber, i;
 
-	/* Make sure -values is fully populated:
-	 */
-	Tcl_ListObjLength(interp, item->valuesObj, &length);
-	while (length < tv->tree.nColumns) {
-	    Tcl_Obj *empty = Tcl_NewStringObj("",0);
-	    Tcl_ListObjAppendElement(interp, item->valuesObj, empty);
-	    ++length;
-	}
+    if (objc != 4) {
+	Tcl_WrongNumArgs(interp, 2, objv, "column itemValueList");
+	return TCL_ERROR;
+    }
+    if (!(column = FindColumn(interp, tv, objv[2]))) {
+	return TCL_ERROR;
+    }
+    if (column == &tv->tree.column0) {
+	Tcl_SetObjResult(interp, Tcl_NewStringObj(
+		"Display column #0 cannot be set", -1));
+	Tcl_SetErrorCode(interp, "TTK", "TREE", "COLUMN_0", NULL);
+	return TCL_ERROR;
+    }
+    columnNumber = column - tv->tree.columns;
 
-	/* Set value:
-	 */
-	Tcl_ListObjReplace(interp,item->valuesObj,columnNumber,1,1,objv+4);
-	TtkRedisplayWidget(&tv->core);
-	return TCL_OK;
+    if (Tcl_ListObjGetElements(interp, objv[3], &nElements, &elements)
+	    != TCL_OK) {
+	return TCL_ERROR;
+    }
+    if (nElements % 2) {
+	Tcl_SetObjResult(interp, Tcl_NewStringObj(
+		"Item/value list must have an even number of elements", -1));
+	Tcl_SetErrorCode(interp, "TTK", "VALUE", "PAIRS", NULL);
+	return TCL_ERROR;
+    }
+
+    items = (TreeItem **)ckalloc((nElements / 2 + 1) * sizeof(TreeItem *));
+    for (i = 0; i < nElements / 2; ++i) {
+	if (!(items[i] = FindItem(interp, tv, elements[2 * i]))) {
+	    ckfree(items);
+	    return TCL_ERROR;
+	}
+    }
+    for (i = 0; i < nElements / 2; ++i) {
+	SetItemValue(tv, items[i], columnNumber, elements[2 * i + 1]);
+	RedisplayItem(tv, items[i]);
     }
+    ckfree(items);
+    return TCL_OK;
 }
 
 /*------------------------------------------------------------------------
  * +++ Widget commands -- tree modification.
  */
 
+/* + CreateItemEntry --
+ *	Create the hash table entry for a new item named itemName,
+ *	or for a new autogenerated name if itemName is NULL.
+ *	Returns NULL and leaves an error message in interp if the
+ *	item already exists.
+ */
+static Tcl_HashEntry *CreateItemEntry(
+    Tcl_Interp *interp, Treeview *tv, const char *itemName)
+{
+    Tcl_HashEntry *entryPtr;
+    int isNew;
+
+    if (itemName) {
+	entryPtr = Tcl_CreateHashEntry(&tv->tree.items, itemName, &isNew);
+	if (!isNew) {
+	    Tcl_SetObjResult(interp, Tcl_ObjPrintf(
+		"Item %s already exists", itemName));
+	    Tcl_SetErrorCode(interp, "TTK", "TREE", "ITEM_EXISTS", NULL);
+	    return NULL;
+	}
+    } else {
+	char idbuf[16];
+	do {
+	    ++tv->tree.serial;
+	    snprintf(idbuf, sizeof(idbuf), "I%03X", tv->tree.serial);
+	    entryPtr = Tcl_CreateHashEntry(&tv->tree.items, idbuf, &isNew);
+	} while (!isNew);
+    }
+    return entryPtr;
+}
+
+/* + CopyItemOptions --
+ *	Create a new item with the same options as the specified one.
+ *	Tcl_Obj option values and the image specification are shared,
+ *	not copied.
+ */
+static TreeItem *CopyItemOptions(Treeview *tv, TreeItem *protoItem)
+{
+    TreeItem *item = NewItem();
+
+#define COPY_OBJ(field) \
+    if ((item->field = protoItem->field) != NULL) { \
+	Tcl_IncrRefCount(item->field); \
+    }
+    COPY_OBJ(textObj)
+    COPY_OBJ(imageObj)
+    COPY_OBJ(valuesObj)
+    COPY_OBJ(openObj)
+    COPY_OBJ(tagsObj)
+    COPY_OBJ(imageAnchorObj)
+#undef COPY_OBJ
+
+    item->state = protoItem->state;
+    item->hidden = protoItem->hidden;
+    item->height = protoItem->height;
+    item->tagset = Ttk_GetTagSetFromObj(NULL, tv->tree.tagTable, NULL);
+    Ttk_TagSetAddSet(item->tagset, protoItem->tagset);
+    if (protoItem->imagespec) {
+	item->imagespec = TtkShareImageSpec(protoItem->imagespec);
+    }
+    return item;
+}
+
 /* + $tv insert $parent $index ?-id id? ?-option value ...?
  *	Insert a new item.
  */
@@ -3258,7 +4280,6 @@ static int TreeviewInsertCommand(
     Treeview *tv = (Treeview *)recordPtr;
     TreeItem *parent, *sibling, *newItem;
     Tcl_HashEntry *entryPtr;
-    int isNew;
 
     if (objc < 4) {
 	Tcl_WrongNumArgs(interp, 2, objv, "parent index ?-id id? -options...");
@@ -3288,23 +4309,13 @@ static int TreeviewInsertCommand(
      */
     objc -= 4; objv += 4;
     if (objc >= 2 && !strcmp("-id", Tcl_GetString(objv[0]))) {
-	const char *itemName = Tcl_GetString(objv[1]);
-
-	entryPtr = Tcl_CreateHashEntry(&tv->tree.items, itemName, &isNew);
-	if (!isNew) {
-	    Tcl_SetObjResult(interp, Tcl_ObjPrintf(
-		"Item %s already exists", itemName));
-	    Tcl_SetErrorCode(interp, "TTK", "TREE", "ITEM_EXISTS", NULL);
+	entryPtr = CreateItemEntry(interp, tv, Tcl_GetString(objv[1]));
+	if (!entryPtr) {
 	    return TCL_ERROR;
 	}
 	objc -= 2; objv += 2;
     } else {
-	char idbuf[16];
-	do {
-	    ++tv->tree.serial;
-	    snprintf(idbuf, sizeof(idbuf), "I%03X", tv->tree.serial);
-	    entryPtr = Tcl_CreateHashEntry(&tv->tree.items, idbuf, &isNew);
-	} while (!isNew);
+	entryPtr = CreateItemEntry(interp, tv, NULL);
     }
 
     /* Create and configure new item:
@@ -3323,14 +4334,123 @@ static int TreeviewInsertCommand(
      */
     Tcl_SetHashValue(entryPtr, newItem);
     newItem->entryPtr = entryPtr;
+    InvalidateInsertion(tv, parent, sibling);
     InsertItem(parent, sibling, newItem);
-    tv->tree.rowPosNeedsUpdate = 1;
     TtkRedisplayWidget(&tv->core);
 
     Tcl_SetObjResult(interp, ItemID(tv, newItem));
     return TCL_OK;
 }
 
+/* + $tv insertrows $parent $index $rows ?-option value ...?
+ *	Insert a new item for each element of $rows, a list of
+ *	{id text values tags} records.  Trailing fields may be omitted,
+ *	and an empty id generates a new one.  The options are processed
+ *	once and apply to every new item; fields given in a row override
+ *	them.  Either all items are inserted or none are.
+ *	Returns the list of new item IDs.
+ */
+static int TreeviewInsertRowsCommand(
+    void *recordPtr, Tcl_Interp *interp, Tcl_Size objc, Tcl_Obj *const objv[])
+{
+    Treeview *tv = (Treeview *)recordPtr;
+    TreeItem *parent, *sibling, *protoItem, *item, **newItems;
+    Tcl_HashEntry *entryPtr;
+    Tcl_Obj **rows, **fields, *result;
+    Tcl_Size nRows, nFields, nNew = 0, i;
+
+    if (objc < 5) {
+	Tcl_WrongNumArgs(interp, 2, objv, "parent index rows ?-option value ...?");
+	return TCL_ERROR;
+    }
+    if ((parent = FindItem(interp, tv, objv[2])) == NULL) {
+	return TCL_ERROR;
+    }
+    if (!strcmp(Tcl_GetString(objv[3]), "end")) {
+	sibling = EndPosition(tv, parent);
+    } else {
+	int index;
+	if (Tcl_GetIntFromObj(interp, objv[3], &index) != TCL_OK)
+	    return TCL_ERROR;
+	sibling = InsertPosition(parent, index);
+    }
+    if (Tcl_ListObjGetElements(interp, objv[4], &nRows, &rows) != TCL_OK) {
+	return TCL_ERROR;
+    }
+
+    /* Process options once, into a prototype item:
+     */
+    protoItem = NewItem();
+    Tk_InitOptions(
+	interp, protoItem, tv->tree.itemOptionTable, tv->core.tkwin);
+    protoItem->tagset = Ttk_GetTagSetFromObj(NULL, tv->tree.tagTable, NULL);
+    if (ConfigureItem(interp, tv, protoItem, objc - 5, objv + 5) != TCL_OK) {
+	FreeItem(protoItem);
+	return TCL_ERROR;
+    }
+
+    /* Create all new items before linking any of them into the tree:
+     */
+    newItems = (TreeItem **)ckalloc((nRows + 1) * sizeof(TreeItem *));
+    for (i = 0; i < nRows; ++i) {
+	const char *itemName = NULL;
+
+	if (Tcl_ListObjGetElements(interp, rows[i], &nFields, &fields)
+		!= TCL_OK) {
+	    goto error;
+	}
+	if (nFields > 4) {
+	    Tcl_SetObjResult(interp, Tcl_ObjPrintf(
+		"Bad row \"%s\": must be a list of id, text, values and tags",
+		Tcl_GetString(rows[i])));
+	    Tcl_SetErrorCode(interp, "TTK", "TREE", "ROW", NULL);
+	    goto error;
+	}
+	if (nFields > 0 && Tcl_GetString(fields[0])[0]) {
+	    itemName = Tcl_GetString(fields[0]);
+	}
+	if (!(entryPtr = CreateItemEntry(interp, tv, itemName))) {
+	    goto error;
+	}
+
+	item = CopyItemOptions(tv, protoItem);
+	Tcl_SetHashValue(entryPtr, item);
+	item->entryPtr = entryPtr;
+	newItems[nNew++] = item;
+
+	if (nFields > 1
+		&& SetRowFields(interp, tv, item, nFields - 1, fields + 1)
+		!= TCL_OK) {
+	    goto error;
+	}
+    }
+    FreeItem(protoItem);
+
+    /* Link into tree:
+     */
+    result = Tcl_NewListObj(nNew, NULL);
+    InvalidateInsertion(tv, parent, sibling);
+    for (i = 0; i < nNew; ++i) {
+	InsertItem(parent, sibling, newItems[i]);
+	sibling = newItems[i];
+	Tcl_ListObjAppendElement(NULL, result, ItemID(tv, newItems[i]));
+    }
+    ckfree(newItems);
+    TtkRedisplayWidget(&tv->core);
+
+    Tcl_SetObjResult(interp, result);
+    return TCL_OK;
+
+error:
+    for (i = 0; i < nNew; ++i) {
+	Tcl_DeleteHashEntry(newItems[i]->entryPtr);
+	FreeItem(newItems[i]);
+    }
+    ckfree(newItems);
+    FreeItem(protoItem);
+    return TCL_ERROR;
+}
+
 /* + $tv detach $items --
  *	Unlink each item in $items from the tree.
  */
@@ -3361,10 +4481,10 @@ static int TreeviewDetachCommand(
     }
 
     for (i = 0; items[i]; ++i) {
+	InvalidatePositions(tv, items[i]);
 	DetachItem(items[i]);
     }
 
-    tv->tree.rowPosNeedsUpdate = 1;
     TtkRedisplayWidget(&tv->core);
     ckfree(items);
     return TCL_OK;
@@ -3461,11 +4581,13 @@ static int TreeviewDeleteCommand(
 		selChange = 1;
 	    }
 	}
+	InvalidatePositions(tv, items[i]);
 	delq = DeleteItems(items[i], delq);
     }
 
-    /* Free items:
+    /* Free items; handles resolved so far may refer to them:
      */
+    tv->tree.itemEpoch = NewItemEpoch();
     while (delq) {
 	TreeItem *next = delq->next;
 	if (tv->tree.focus == delq)
@@ -3480,7 +4602,334 @@ static int TreeviewDeleteCommand(
     if (selChange) {
 	Tk_SendVirtualEvent(tv->core.tkwin, "TreeviewSelect", NULL);
     }
-    tv->tree.rowPosNeedsUpdate = 1;
+    TtkRedisplayWidget(&tv->core);
+    return TCL_OK;
+}
+
+/* + $tv sort $item $column ?-option ...? --
+ *	Reorder the children of $item by the values in $column,
+ *	and optionally those of all its descendants.  The sort is
+ *	a stable merge sort, as for [lsort].
+ */
+
+typedef enum {
+    SORT_ASCII, SORT_DICTIONARY, SORT_INTEGER, SORT_REAL
+} SortMode;
+
+typedef struct {
+    SortMode mode;
+    int decreasing;
+    Tcl_Size columnNumber;	/* Data column, or -1 for the tree column */
+} SortSpec;
+
+typedef struct {
+    TreeItem *item;
+    const char *string;		/* for SORT_ASCII and SORT_DICTIONARY */
+    Tcl_WideInt wideValue;	/* for SORT_INTEGER */
+    double doubleValue;		/* for SORT_REAL */
+} SortEntry;
+
+/* + SortKey --
+ *	Returns the value an item is sorted by.
+ */
+static Tcl_Obj *SortKey(SortSpec *spec, TreeItem *item)
+{
+    Tcl_Obj *keyObj = NULL;
+
+    if (spec->columnNumber < 0) {
+	keyObj = item->textObj;
+    } else if (item->valuesObj) {
+	Tcl_ListObjIndex(NULL, item->valuesObj, spec->columnNumber, &keyObj);
+    }
+    return keyObj;
+}
+
+/* + DictionaryCompare --
+ *	Compare two strings as [lsort -dictionary] does: embedded
+ *	numbers compare as integers, and case is only used to break ties.
+ */
+static int DictionaryCompare(const char *left, const char *right)
+{
+    int uniLeft = 0, uniRight = 0, diff, zeros;
+    int secondaryDiff = 0;
+
+    while (1) {
+	if (isdigit(UCHAR(*right)) && isdigit(UCHAR(*left))) {
+	    /* Compare runs of digits numerically: strip leading zeros,
+	     * then the longer run is larger, else the first difference
+	     * decides.  More leading zeros sort first as a tiebreak.
+	     */
+	    zeros = 0;
+	    while ((*right == '0') && isdigit(UCHAR(right[1]))) {
+		right++;
+		zeros--;
+	    }
+	    while ((*left == '0') && isdigit(UCHAR(left[1]))) {
+		left++;
+		zeros++;
+	    }
+	    if (secondaryDiff == 0) {
+		secondaryDiff = zeros;
+	    }
+
+	    diff = 0;
+	    while (1) {
+		if (diff == 0) {
+		    diff = UCHAR(*left) - UCHAR(*right);
+		}
+		right++;
+		left++;
+		if (!isdigit(UCHAR(*right))) {
+		    if (isdigit(UCHAR(*left))) {
+			return 1;
+		    } else if (diff != 0) {
+			return diff;
+		    }
+		    break;
+		} else if (!isdigit(UCHAR(*left))) {
+		    return -1;
+		}
+	    }
+	    continue;
+	}
+
+	if ((*left == '\0') || (*right == '\0')) {
+	    diff = UCHAR(*left) - UCHAR(*right);
+	    break;
+	}
+
+	left += Tcl_UtfToUniChar(left, &uniLeft);
+	right += Tcl_UtfToUniChar(right, &uniRight);
+	diff = Tcl_UniCharToLower(uniLeft) - Tcl_UniCharToLower(uniRight);
+	if (diff) {
+	    return diff;
+	}
+	if (secondaryDiff == 0) {
+	    if (Tcl_UniCharIsUpper(uniLeft) && Tcl_UniCharIsLower(uniRight)) {
+		secondaryDiff = -1;
+	    } else if (Tcl_UniCharIsUpper(uniRight)
+		    && Tcl_UniCharIsLower(uniLeft)) {
+		secondaryDiff = 1;
+	    }
+	}
+    }
+    if (diff == 0) {
+	diff = secondaryDiff;
+    }
+    return diff;
+}
+
+static int CompareSortEntries(
+    SortSpec *spec, const SortEntry *a, const SortEntry *b)
+{
+    int result = 0;
+
+    switch (spec->mode) {
+    case SORT_ASCII:
+	result = strcmp(a->string, b->string);
+	break;
+    case SORT_DICTIONARY:
+	result = DictionaryCompare(a->string, b->string);
+	break;
+    case SORT_INTEGER:
+	result = (a->wideValue > b->wideValue) - (a->wideValue < b->wideValue);
+	break;
+    case SORT_REAL:
+	result =
+	    (a->doubleValue > b->doubleValue) - (a->doubleValue < b->doubleValue);
+	break;
+    }
+    return spec->decreasing ? -result : result;
+}
+
+/* + MergeSort --
+ *	Stable sort of entries[0..n-1], using tmp[] as scratch space.
+ */
+static void MergeSort(
+    SortSpec *spec, SortEntry *entries, SortEntry *tmp, Tcl_Size n)
+{
+    Tcl_Size half = n / 2, i = 0, j = half, k = 0;
+
+    if (n < 2) {
+	return;
+    }
+    MergeSort(spec, entries, tmp, half);
+    MergeSort(spec, entries + half, tmp, n - half);
+    if (CompareSortEntries(spec, &entries[half - 1], &entries[half]) <= 0) {
+	return;	/* already in order */
+    }
+
+    while (i < half && j < n) {
+	if (CompareSortEntries(spec, &entries[j], &entries[i]) < 0) {
+	    tmp[k++] = entries[j++];
+	} else {
+	    tmp[k++] = entries[i++];
+	}
+    }
+    while (i < half) {
+	tmp[k++] = entries[i++];
+    }
+    /* entries[j..n-1] are already in place */
+    memcpy(entries, tmp, k * sizeof(SortEntry));
+}
+
+/* + CheckSortKeys --
+ *	Make sure that the keys of all items to be sorted are numbers,
+ *	as required by -integer and -real, before anything is reordered.
+ */
+static int CheckSortKeys(
+    Tcl_Interp *interp, Treeview *tv, SortSpec *spec,
+    TreeItem *parent, int recursive)
+{
+    TreeItem *child;
+
+    for (child = parent->children; child; child = child->next) {
+	Tcl_Obj *keyObj = SortKey(spec, child);
+	Tcl_WideInt w;
+	double d;
+	int code;
+
+	if (!keyObj) {
+	    keyObj = Tcl_NewObj();
+	}
+	Tcl_IncrRefCount(keyObj);
+	if (spec->mode == SORT_INTEGER) {
+	    code = Tcl_GetWideIntFromObj(interp, keyObj, &w);
+	} else {
+	    code = Tcl_GetDoubleFromObj(interp, keyObj, &d);
+	}
+	Tcl_DecrRefCount(keyObj);
+	if (code != TCL_OK) {
+	    Tcl_AppendObjToErrorInfo(interp, Tcl_ObjPrintf(
+		"\n    (sort key of item \"%s\")", ItemName(tv, child)));
+	    return TCL_ERROR;
+	}
+	if (recursive && CheckSortKeys(interp, tv, spec, child, 1) != TCL_OK) {
+	    return TCL_ERROR;
+	}
+    }
+    return TCL_OK;
+}
+
+/* + SortChildren --
+ *	Reorder the children of parent, and of all their descendants
+ *	if recursive.  *entriesPtr and *tmpPtr are scratch arrays of
+ *	*sizePtr entries, grown as needed.
+ */
+static void SortChildren(
+    SortSpec *spec, TreeItem *parent, int recursive,
+    SortEntry **entriesPtr, SortEntry **tmpPtr, Tcl_Size *sizePtr)
+{
+    TreeItem *child, *prev = NULL;
+    SortEntry *entries;
+    Tcl_Size n = 0, i;
+
+    for (child = parent->children; child; child = child->next) {
+	++n;
+    }
+    if (n > *sizePtr) {
+	*sizePtr = n;
+	*entriesPtr = (SortEntry *)ckrealloc(*entriesPtr, n * sizeof(SortEntry));
+	*tmpPtr = (SortEntry *)ckrealloc(*tmpPtr, n * sizeof(SortEntry));
+    }
+    entries = *entriesPtr;
+
+    for (child = parent->children, i = 0; child; child = child->next, ++i) {
+	Tcl_Obj *keyObj = SortKey(spec, child);
+
+	entries[i].item = child;
+	entries[i].string = keyObj ? Tcl_GetString(keyObj) : "";
+	entries[i].wideValue = 0;
+	entries[i].doubleValue = 0.0;
+	if (keyObj && spec->mode == SORT_INTEGER) {
+	    Tcl_GetWideIntFromObj(NULL, keyObj, &entries[i].wideValue);
+	} else if (keyObj && spec->mode == SORT_REAL) {
+	    Tcl_GetDoubleFromObj(NULL, keyObj, &entries[i].doubleValue);
+	}
+    }
+    MergeSort(spec, entries, *tmpPtr, n);
+
+    /* Relink the children in sorted order:
+     */
+    parent->children = n ? entries[0].item : NULL;
+    for (i = 0; i < n; ++i) {
+	child = entries[i].item;
+	child->prev = prev;
+	child->next = (i + 1 < n) ? entries[i + 1].item : NULL;
+	prev = child;
+    }
+
+    if (recursive) {
+	for (child = parent->children; child; child = child->next) {
+	    if (child->children) {
+		SortChildren(spec, child, 1, entriesPtr, tmpPtr, sizePtr);
+	    }
+	}
+    }
+}
+
+static int TreeviewSortCommand(
+    void *recordPtr, Tcl_Interp *interp, Tcl_Size objc, Tcl_Obj *const objv[])
+{
+    static const char *const sortOptionStrings[] = {
+	"-ascii", "-decreasing", "-dictionary", "-increasing",
+	"-integer", "-real", "-recursive", NULL
+    };
+    enum {
+	OPT_ASCII, OPT_DECREASING, OPT_DICTIONARY, OPT_INCREASING,
+	OPT_INTEGER, OPT_REAL, OPT_RECURSIVE
+    };
+    Treeview *tv = (Treeview *)recordPtr;
+    TreeItem *item;
+    TreeColumn *column;
+    SortSpec spec;
+    SortEntry *entries = NULL, *tmp = NULL;
+    Tcl_Size size = 0, i;
+    int recursive = 0;
+
+    if (objc < 4) {
+	Tcl_WrongNumArgs(interp, 2, objv, "item column ?-option ...?");
+	return TCL_ERROR;
+    }
+    if (!(item = FindItem(interp, tv, objv[2]))
+	    || !(column = FindColumn(interp, tv, objv[3]))) {
+	return TCL_ERROR;
+    }
+
+    spec.mode = SORT_ASCII;
+    spec.decreasing = 0;
+    spec.columnNumber = (column == &tv->tree.column0)
+	    ? -1 : (column - tv->tree.columns);
+
+    for (i = 4; i < objc; ++i) {
+	int option;
+	if (Tcl_GetIndexFromObjStruct(interp, objv[i], sortOptionStrings,
+		sizeof(char *), "option", 0, &option) != TCL_OK) {
+	    return TCL_ERROR;
+	}
+	switch (option) {
+	case OPT_ASCII:		spec.mode = SORT_ASCII; break;
+	case OPT_DICTIONARY:	spec.mode = SORT_DICTIONARY; break;
+	case OPT_INTEGER:	spec.mode = SORT_INTEGER; break;
+	case OPT_REAL:		spec.mode = SORT_REAL; break;
+	case OPT_DECREASING:	spec.decreasing = 1; break;
+	case OPT_INCREASING:	spec.decreasing = 0; break;
+	case OPT_RECURSIVE:	recursive = 1; break;
+	}
+    }
+
+    if ((spec.mode == SORT_INTEGER || spec.mode == SORT_REAL)
+	    && CheckSortKeys(interp, tv, &spec, item, recursive) != TCL_OK) {
+	return TCL_ERROR;
+    }
+
+    InvalidatePositions(tv, item);
+    SortChildren(&spec, item, recursive, &entries, &tmp, &size);
+    if (entries) {
+	ckfree(entries);
+	ckfree(tmp);
+    }
+
     TtkRedisplayWidget(&tv->core);
     return TCL_OK;
 }
@@ -3539,10 +4988,11 @@ static int TreeviewMoveCommand(
 
     /* Move item:
      */
+    InvalidatePositions(tv, item);
     DetachItem(item);
+    InvalidateInsertion(tv, parent, sibling);
     InsertItem(parent, sibling, item);
 
-    tv->tree.rowPosNeedsUpdate = 1;
     TtkRedisplayWidget(&tv->core);
     return TCL_OK;
 }
@@ -3596,7 +5046,7 @@ static int TreeviewSeeCommand(
 	    parent->openObj = unshareObj(parent->openObj);
 	    Tcl_SetBooleanObj(parent->openObj, 1);
 	    parent->state |= TTK_STATE_OPEN;
-	    tv->tree.rowPosNeedsUpdate = 1;
+	    InvalidatePositions(tv, parent);
 	    TtkRedisplayWidget(&tv->core);
 	}
     }
@@ -4153,6 +5603,7 @@ static int TreeviewTagDeleteCommand(
     Treeview *tv = (Treeview *)recordPtr;
     Ttk_TagTable tagTable = tv->tree.tagTable;
     TreeItem *item = tv->tree.root;
+    VirtualRow *row;
     Ttk_Tag tag;
 
     if (objc != 4) {
@@ -4167,6 +5618,9 @@ static int TreeviewTagDeleteCommand(
 	RemoveTag(item, tag);
 	item = NextPreorder(item);
     }
+    for (row = tv->tree.lruFirst; row; row = row->next) {
+	RemoveTag(row->item, tag);
+    }
     /* then remove the tag from the tag table */
     Tk_DeleteAllBindings(tv->tree.bindingTable, tag);
     Ttk_DeleteTagFromTable(tagTable, tag);
@@ -4524,6 +5978,140 @@ static const Ttk_Ensemble TreeviewTagCommands[] = {
     { 0,0,0 }
 };
 
+/*------------------------------------------------------------------------
+ * +++ Widget commands -- virtual rows.
+ */
+
+/* + GetVirtualIndex --
+ *	Get a virtual row index from a Tcl_Obj;
+ *	returns an error if it is out of range.
+ */
+static int GetVirtualIndex(
+    Tcl_Interp *interp, Treeview *tv, Tcl_Obj *objPtr, Tcl_WideInt *indexPtr)
+{
+    if (Tcl_GetWideIntFromObj(interp, objPtr, indexPtr) != TCL_OK) {
+	return TCL_ERROR;
+    }
+    if (*indexPtr < 0 || *indexPtr >= tv->tree.virtualRows) {
+	Tcl_SetObjResult(interp, Tcl_ObjPrintf(
+	    "Virtual row %s out of range", Tcl_GetString(objPtr)));
+	Tcl_SetErrorCode(interp, "TTK", "TREE", "VIRTUALROW", NULL);
+	return TCL_ERROR;
+    }
+    return TCL_OK;
+}
+
+/* + $tv virtual identify $y --
+ *	Return the index of the virtual row at y, or {} if none.
+ */
+static int TreeviewVirtualIdentifyCommand(
+    void *recordPtr, Tcl_Interp *interp, Tcl_Size objc, Tcl_Obj *const objv[])
+{
+    Treeview *tv = (Treeview *)recordPtr;
+    Tcl_WideInt index;
+    int y, row;
+
+    if (objc != 4) {
+	Tcl_WrongNumArgs(interp, 3, objv, "y");
+	return TCL_ERROR;
+    }
+    if (Tk_GetPixelsFromObj(interp, tv->core.tkwin, objv[3], &y) != TCL_OK) {
+	return TCL_ERROR;
+    }
+    if (tv->tree.rowPosNeedsUpdate) {
+	UpdatePositionTree(tv);
+    }
+    TtkUpdateScrollInfo(tv->tree.yscrollHandle);
+
+    if (!tv->tree.rowCommandObj || y < tv->tree.treeArea.y
+	    || tv->tree.rowHeight <= 0) {
+	return TCL_OK;
+    }
+    row = (y - tv->tree.treeArea.y) / tv->tree.rowHeight;
+    if (row >= tv->tree.titleRows) {
+	row += tv->tree.yscroll.first;
+    }
+    index = row - tv->tree.virtualFirstRow;
+    if (index >= 0 && index < tv->tree.virtualRows) {
+	Tcl_SetObjResult(interp, Tcl_NewWideIntObj(index));
+    }
+    return TCL_OK;
+}
+
+/* + $tv virtual refresh ?$first ?$last?? --
+ *	Discard materialized virtual rows, so that the -rowcommand
+ *	is called again for those in view.
+ */
+static int TreeviewVirtualRefreshCommand(
+    void *recordPtr, Tcl_Interp *interp, Tcl_Size objc, Tcl_Obj *const objv[])
+{
+    Treeview *tv = (Treeview *)recordPtr;
+    Tcl_WideInt first = 0, last = -1;
+
+    if (objc > 5) {
+	Tcl_WrongNumArgs(interp, 3, objv, "?first? ?last?");
+	return TCL_ERROR;
+    }
+    if (objc > 3 && GetVirtualIndex(interp, tv, objv[3], &first) != TCL_OK) {
+	return TCL_ERROR;
+    }
+    last = first;
+    if (objc == 3) {
+	last = -1;
+    } else if (objc == 5
+	    && GetVirtualIndex(interp, tv, objv[4], &last) != TCL_OK) {
+	return TCL_ERROR;
+    }
+
+    FlushVirtualRows(tv, first, last);
+    TtkRedisplayWidget(&tv->core);
+    return TCL_OK;
+}
+
+/* + $tv virtual see $index --
+ *	Scroll so that the specified virtual row is visible.
+ */
+static int TreeviewVirtualSeeCommand(
+    void *recordPtr, Tcl_Interp *interp, Tcl_Size objc, Tcl_Obj *const objv[])
+{
+    Treeview *tv = (Treeview *)recordPtr;
+    Tcl_WideInt index;
+    int visibleRows, scrollRow;
+
+    if (objc != 4) {
+	Tcl_WrongNumArgs(interp, 3, objv, "index");
+	return TCL_ERROR;
+    }
+    if (GetVirtualIndex(interp, tv, objv[3], &index) != TCL_OK) {
+	return TCL_ERROR;
+    }
+    if (tv->tree.rowPosNeedsUpdate) {
+	UpdatePositionTree(tv);
+    }
+    TtkUpdateScrollInfo(tv->tree.yscrollHandle);
+    if (!tv->tree.rowCommandObj || tv->tree.rowHeight <= 0) {
+	return TCL_OK;
+    }
+
+    visibleRows = tv->tree.treeArea.height / tv->tree.rowHeight
+	    - tv->tree.titleRows;
+    scrollRow = tv->tree.virtualFirstRow + (int)index - tv->tree.titleRows;
+    if (scrollRow >= tv->tree.yscroll.first + visibleRows) {
+	TtkScrollTo(tv->tree.yscrollHandle, 1 + scrollRow - visibleRows, 1);
+    }
+    if (scrollRow < tv->tree.yscroll.first || visibleRows < 1) {
+	TtkScrollTo(tv->tree.yscrollHandle, scrollRow, 1);
+    }
+    return TCL_OK;
+}
+
+static const Ttk_Ensemble TreeviewVirtualCommands[] = {
+    { "identify",	TreeviewVirtualIdentifyCommand,0 },
+    { "refresh",	TreeviewVirtualRefreshCommand,0 },
+    { "see",		TreeviewVirtualSeeCommand,0 },
+    { 0,0,0 }
+};
+
 /*------------------------------------------------------------------------
  * +++ Widget commands record.
  */
@@ -4545,6 +6133,7 @@ static const Ttk_Ensemble TreeviewCommands[] = {
     { "identify",	TreeviewIdentifyCommand,0 },
     { "index",	TreeviewIndexCommand,0 },
     { "insert",	TreeviewInsertCommand,0 },
+    { "insertrows",	TreeviewInsertRowsCommand,0 },
     { "instate",	TtkWidgetInstateCommand,0 },
     { "item",		TreeviewItemCommand,0 },
     { "move",		TreeviewMoveCommand,0 },
@@ -4554,9 +6143,12 @@ static const Ttk_Ensemble TreeviewCommands[] = {
     { "see",		TreeviewSeeCommand,0 },
     { "selection",	TreeviewSelectionCommand,0 },
     { "set",		TreeviewSetCommand,0 },
+    { "setcolumn",	TreeviewSetColumnCommand,0 },
+    { "sort",		TreeviewSortCommand,0 },
     { "state",	TtkWidgetStateCommand,0 },
     { "style",		TtkWidgetStyleCommand,0 },
     { "tag",	0,TreeviewTagCommands },
+    { "virtual",	0,TreeviewVirtualCommands },
     { "xview",	TreeviewXViewCommand,0 },
     { "yview",	TreeviewYViewCommand,0 },
     { 0,0,0 }
@@ -4766,6 +6358,7 @@ TtkTreeview_Init(Tcl_Interp *interp)
 {
     Ttk_Theme theme = Ttk_GetDefaultTheme(interp);
 
+    TreeItemTypeInit();
     RegisterWidget(interp, "ttk::treeview", &TreeviewWidgetSpec);
 
     Ttk_RegisterElement(interp, theme, "Treeitem.indicator",
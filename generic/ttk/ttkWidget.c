@@ -97,10 +97,15 @@ static void DrawWidget(void *recordPtr)
 
     corePtr->flags &= ~REDISPLAY_PENDING;
     if (Tk_IsMapped(corePtr->tkwin)) {
+	Tcl_WideInt statsStart = TkStatsStart();
 	Drawable d = BeginDrawing(corePtr->tkwin);
 	corePtr->widgetSpec->layoutProc(recordPtr);
 	corePtr->widgetSpec->displayProc(recordPtr, d);
 	EndDrawing(corePtr->tkwin, d);
+	if (statsStart != 0) {
+	    TkStatsRecord(TK_STATS_REDISPLAY, Tk_Class(corePtr->tkwin),
+		    statsStart);
+	}
     }
 }
 
@@ -114,7 +119,7 @@ void TtkRedisplayWidget(WidgetCore *corePtr)
     }
 
     if (!(corePtr->flags & REDISPLAY_PENDING)) {
-	Tcl_DoWhenIdle(DrawWidget, corePtr);
+	TkScheduleRedraw(corePtr->tkwin, DrawWidget, corePtr);
 	corePtr->flags |= REDISPLAY_PENDING;
     }
 }
@@ -129,6 +134,7 @@ static void WidgetWorldChanged(void *clientData)
 {
     WidgetCore *corePtr = (WidgetCore *)clientData;
     (void)UpdateLayout(corePtr->interp, corePtr);
+    Ttk_InvalidateLayout(corePtr->layout);
     SizeChanged(corePtr);
     TtkRedisplayWidget(corePtr);
 }
@@ -224,7 +230,7 @@ DestroyWidget(WidgetCore *corePtr)
     }
 
     if (corePtr->flags & REDISPLAY_PENDING) {
-	Tcl_CancelIdleCall(DrawWidget, corePtr);
+	TkCancelRedraw(DrawWidget, corePtr);
     }
 
     corePtr->tkwin = NULL;
@@ -653,6 +659,7 @@ int TtkWidgetConfigureCommand(
 	    return status;
 	}
 
+	Ttk_InvalidateLayout(corePtr->layout);
 	if (mask & (STYLE_CHANGED | GEOMETRY_CHANGED)) {
 	    SizeChanged(corePtr);
 	}
@@ -305,6 +305,7 @@ testConstraint testmetrics     [llength [info commands testmetrics]]
 testConstraint testmovemouse   [llength [info commands testmovemouse]]
 testConstraint testobjconfig   [llength [info commands testobjconfig]]
 testConstraint testpressbutton [llength [info commands testpressbutton]]
+testConstraint testqueueevents [llength [info commands testqueueevents]]
 testConstraint testsend        [llength [info commands testsend]]
 testConstraint testtext        [llength [info commands testtext]]
 testConstraint testwinevent    [llength [info commands testwinevent]]
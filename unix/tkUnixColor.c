@@ -47,6 +47,10 @@ static void		DeleteStressedCmap(Display *display,
 			    Colormap colormap);
 static void		FindClosestColor(Tk_Window tkwin,
 			    XColor *desiredColorPtr, XColor *actualColorPtr);
+static int		GetTrueColorPixel(Tk_Window tkwin,
+			    XColor *colorPtr);
+static unsigned long	ScaleToMask(unsigned short *valuePtr,
+			    unsigned long mask);
 
 /*
  *----------------------------------------------------------------------
@@ -86,6 +90,7 @@ TkpFreeColor(
 
     visual = tkColPtr->visual;
     if ((visual->c_class != StaticGray) && (visual->c_class != StaticColor)
+	    && (visual->c_class != TrueColor)
 	    && (tkColPtr->color.pixel != BlackPixelOfScreen(screen))
 	    && (tkColPtr->color.pixel != WhitePixelOfScreen(screen))) {
 	Tk_ErrorHandler handler;
@@ -130,7 +135,9 @@ TkpGetColor(
     /*
      * Map from the name to a pixel value. Call XAllocNamedColor rather than
      * XParseColor for non-# names: this saves a server round-trip for those
-     * names.
+     * names. On a TrueColor visual the pixel value is a function of the RGB
+     * values alone, so names found in the built-in color table need no
+     * server round-trip at all.
      */
 
     if (*name != '#') {
@@ -158,7 +165,10 @@ TkpGetColor(
 	if (strlen(name) > 99) {
 	/* Don't bother to parse this. [Bug 2809525]*/
 	return NULL;
-    } else if (XAllocNamedColor(display, colormap, name, &screen, &color) != 0) {
+	} else if ((Tk_Visual(tkwin)->c_class == TrueColor)
+		&& TkParseColorName(name, &color)) {
+	    GetTrueColorPixel(tkwin, &color);
+	} else if (XAllocNamedColor(display, colormap, name, &screen, &color) != 0) {
 	    DeleteStressedCmap(display, colormap);
 	} else {
 	    /*
@@ -178,7 +188,9 @@ TkpGetColor(
 	if (TkParseColor(display, colormap, name, &color) == 0) {
 	    return NULL;
 	}
-	if (XAllocColor(display, colormap, &color) != 0) {
+	if (GetTrueColorPixel(tkwin, &color)) {
+	    /* Computed locally; nothing was allocated. */
+	} else if (XAllocColor(display, colormap, &color) != 0) {
 	    DeleteStressedCmap(display, colormap);
 	} else {
 	    FindClosestColor(tkwin, &color, &color);
@@ -225,7 +237,9 @@ TkpGetColorByValue(
     tkColPtr->color.red = colorPtr->red;
     tkColPtr->color.green = colorPtr->green;
     tkColPtr->color.blue = colorPtr->blue;
-    if (XAllocColor(display, colormap, &tkColPtr->color) != 0) {
+    if (GetTrueColorPixel(tkwin, &tkColPtr->color)) {
+	/* Computed locally; nothing was allocated. */
+    } else if (XAllocColor(display, colormap, &tkColPtr->color) != 0) {
 	DeleteStressedCmap(display, colormap);
     } else {
 	FindClosestColor(tkwin, &tkColPtr->color, &tkColPtr->color);
@@ -234,6 +248,88 @@ TkpGetColorByValue(
     return tkColPtr;
 }
 
+/*
+ *----------------------------------------------------------------------
+ *
+ * GetTrueColorPixel --
+ *
+ *	On a TrueColor visual, compute the pixel value for a color directly
+ *	from the visual's channel masks, as XAllocColor would, but without a
+ *	round-trip to the server.
+ *
+ * Results:
+ *	Returns 1 and fills in the pixel and flags fields of *colorPtr if
+ *	tkwin uses a TrueColor visual, and 0 otherwise. The red, green and
+ *	blue fields are rounded to the intensities the visual can actually
+ *	display.
+ *
+ * Side effects:
+ *	None.
+ *
+ *----------------------------------------------------------------------
+ */
+
+static int
+GetTrueColorPixel(
+    Tk_Window tkwin,		/* Window in which color will be used. */
+    XColor *colorPtr)		/* Red, green and blue fields indicate the
+				 * desired color. */
+{
+    Visual *visual = Tk_Visual(tkwin);
+
+    if (visual->c_class != TrueColor) {
+	return 0;
+    }
+    colorPtr->pixel = ScaleToMask(&colorPtr->red, visual->red_mask)
+	    | ScaleToMask(&colorPtr->green, visual->green_mask)
+	    | ScaleToMask(&colorPtr->blue, visual->blue_mask);
+    colorPtr->flags = DoRed|DoGreen|DoBlue;
+    return 1;
+}
+
+/*
+ *----------------------------------------------------------------------
+ *
+ * ScaleToMask --
+ *
+ *	Scale a 16-bit color intensity to the bits of a TrueColor channel
+ *	mask, rounding to the nearest value the way the X server does when it
+ *	allocates a color on a TrueColor visual.
+ *
+ * Results:
+ *	The channel's contribution to the pixel value. *valuePtr is replaced
+ *	by the 16-bit intensity the server reports for that value, so that
+ *	"winfo rgb" returns the same values as with XAllocColor.
+ *
+ * Side effects:
+ *	None.
+ *
+ *----------------------------------------------------------------------
+ */
+
+static unsigned long
+ScaleToMask(
+    unsigned short *valuePtr,	/* 16-bit intensity; updated in place. */
+    unsigned long mask)		/* Channel mask from the visual. */
+{
+    int shift = 0, bits = 0;
+    unsigned long v, maxValue;
+
+    if (mask == 0) {
+	return 0;
+    }
+    while (!((mask >> shift) & 1)) {
+	shift++;
+    }
+    while (((mask >> (shift + bits)) & 1) && (bits < 16)) {
+	bits++;
+    }
+    maxValue = (1UL << bits) - 1;
+    v = (*valuePtr * maxValue + 0x8000) >> 16;
+    *valuePtr = (unsigned short) (v * 65535 / maxValue);
+    return (v << shift) & mask;
+}
+
 /*
  *----------------------------------------------------------------------
  *
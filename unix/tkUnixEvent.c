@@ -27,10 +27,34 @@ typedef struct {
 } ThreadSpecificData;
 static Tcl_ThreadDataKey dataKey;
 
+/*
+ * Upper bound for the number of queued events looked at per coalescing
+ * candidate. The look-ahead takes events off the X queue and puts them back,
+ * so its cost per candidate stays bounded however long the queue is.
+ */
+
+#define MAX_COALESCE_SCAN 64
+
+/*
+ * Area of Expose events dropped while transferring events, waiting to be
+ * merged into the next Expose event for the same window.
+ */
+
+typedef struct {
+    int left, top, right, bottom;
+} ExposeArea;
+
 /*
  * Prototypes for functions that are referenced only in this file:
  */
 
+static int		CoalesceEvent(TkDisplay *dispPtr, XEvent *eventPtr,
+			    Tcl_HashTable *exposeTablePtr);
+static int		ScanQueuedEvent(XEvent *candPtr, XEvent *eventPtr);
+static int		ScanXEventQueue(Display *display, XEvent *candPtr);
+static void		UnionExposeArea(ExposeArea *areaPtr,
+			    XEvent *eventPtr);
+
 static void		DisplayCheckProc(void *clientData, int flags);
 static void		DisplayExitHandler(void *clientData);
 static void		DisplayFileProc(void *clientData, int flags);
@@ -352,6 +376,22 @@ TransferXEventsToTcl(
     } event;
     Window w;
     TkDisplay *dispPtr = NULL;
+    TkDisplay *coalescePtr = TkGetDisplay(display);
+    Tcl_HashTable exposeTable;
+    Tcl_HashEntry *hPtr;
+    Tcl_HashSearch search;
+
+    /*
+     * Coalescing is only done if some policy was set for this display.
+     */
+
+    if (coalescePtr && !coalescePtr->coalesceMask
+	    && !(coalescePtr->flags & TK_DISPLAY_COALESCE_WINDOWS)) {
+	coalescePtr = NULL;
+    }
+    if (coalescePtr) {
+	Tcl_InitHashTable(&exposeTable, TCL_ONE_WORD_KEYS);
+    }
 
     /*
      * Transfer events from the X event queue to the Tk event queue after XIM
@@ -387,6 +427,9 @@ TransferXEventsToTcl(
 	if (XFilterEvent(&event.x, w)) {
 	    continue;
 	}
+	if (coalescePtr && CoalesceEvent(coalescePtr, &event.x, &exposeTable)) {
+	    continue;
+	}
 	if (event.type == KeyPress || event.type == KeyRelease) {
 	    event.k.charValuePtr = NULL;
 	    event.k.charValueLen = 0;
@@ -414,8 +457,300 @@ TransferXEventsToTcl(
 	}
 	Tk_QueueWindowEvent(&event.x, TCL_QUEUE_TAIL);
     }
+
+    if (coalescePtr) {
+	for (hPtr = Tcl_FirstHashEntry(&exposeTable, &search); hPtr != NULL;
+		hPtr = Tcl_NextHashEntry(&search)) {
+	    ckfree(Tcl_GetHashValue(hPtr));
+	}
+	Tcl_DeleteHashTable(&exposeTable);
+    }
 }
-
+
+/*
+ *----------------------------------------------------------------------
+ *
+ * CoalesceEvent --
+ *
+ *	Apply the coalescing policy of the event's window (see "tk coalesce")
+ *	to an event just taken from the X event queue. Motion and
+ *	ConfigureNotify events are dropped if a later event of the same kind
+ *	for the same window is already queued, with nothing in between that
+ *	must be seen first. Expose events are dropped the same way, but their
+ *	area is remembered and merged into the Expose event that survives.
+ *	Consecutive mouse wheel clicks on the same window are summed into a
+ *	single MouseWheel event.
+ *
+ * Results:
+ *	Returns 1 if the event was dropped, 0 if it must be queued.
+ *
+ * Side effects:
+ *	May remove wheel events from the X event queue, and may modify
+ *	eventPtr.
+ *
+ *----------------------------------------------------------------------
+ */
+
+static int
+CoalesceEvent(
+    TkDisplay *dispPtr,		/* Display the event came from. */
+    XEvent *eventPtr,		/* Event taken from the X event queue. */
+    Tcl_HashTable *exposeTablePtr)
+				/* Areas of dropped Expose events, keyed by
+				 * window. */
+{
+    Display *display = dispPtr->display;
+    Window window = eventPtr->xany.window;
+    TkWindow *winPtr;
+    XEvent next;
+    int mask, type, state;
+
+    switch (eventPtr->type) {
+    case MotionNotify:
+	type = TK_COALESCE_MOTION;
+	break;
+    case ConfigureNotify:
+	type = TK_COALESCE_CONFIGURE;
+	break;
+    case Expose:
+	type = TK_COALESCE_EXPOSE;
+	break;
+    case ButtonPress:
+	if ((eventPtr->xbutton.button < Button4)
+		|| (eventPtr->xbutton.button >= Button8)) {
+	    return 0;
+	}
+	type = TK_COALESCE_WHEEL;
+	break;
+    default:
+	return 0;
+    }
+
+    mask = dispPtr->coalesceMask;
+    if (dispPtr->flags & TK_DISPLAY_COALESCE_WINDOWS) {
+	winPtr = (TkWindow *) Tk_IdToWindow(display, window);
+	if (winPtr && (winPtr->coalesceMask >= 0)) {
+	    mask = winPtr->coalesceMask;
+	}
+    }
+
+    /*
+     * Pointer input is only coalesced with the events directly following it,
+     * since its order relative to any other input matters.
+     */
+
+    if (type == TK_COALESCE_MOTION) {
+	if (!(mask & type) || (QLength(display) == 0)) {
+	    return 0;
+	}
+	XPeekEvent(display, &next);
+	return (next.type == MotionNotify) && (next.xmotion.window == window)
+		&& (next.xmotion.state == eventPtr->xmotion.state);
+    }
+    if (type == TK_COALESCE_WHEEL) {
+	unsigned int button = eventPtr->xbutton.button;
+	int clicks = 1;
+
+	if (!(mask & type)) {
+	    return 0;
+	}
+	while (QLength(display) > 0) {
+	    XPeekEvent(display, &next);
+	    if ((next.xany.window != window)
+		    || (next.xbutton.button != button)
+		    || ((next.type != ButtonRelease)
+		    && ((next.type != ButtonPress)
+		    || (next.xbutton.state != eventPtr->xbutton.state)))) {
+		break;
+	    }
+	    XNextEvent(display, &next);
+	    if (next.type == ButtonPress) {
+		clicks++;
+	    }
+	}
+	if (clicks > 1) {
+	    /*
+	     * Same conversion as in Tk_HandleEvent, with the summed delta.
+	     */
+
+	    eventPtr->type = MouseWheelEvent;
+	    eventPtr->xany.send_event = -1;
+	    eventPtr->xkey.keycode = clicks * ((button & 1) ? -120 : 120);
+	    if (button > Button5) {
+		eventPtr->xkey.state |= ShiftMask;
+	    }
+	}
+	return 0;
+    }
+
+    state = (mask & type) ? ScanXEventQueue(display, eventPtr) : 0;
+
+    if (type == TK_COALESCE_EXPOSE) {
+	Tcl_HashEntry *hPtr;
+	ExposeArea *areaPtr;
+	int isNew;
+
+	if (state > 0) {
+	    hPtr = Tcl_CreateHashEntry(exposeTablePtr, INT2PTR(window), &isNew);
+	    if (isNew) {
+		areaPtr = (ExposeArea *)ckalloc(sizeof(ExposeArea));
+		areaPtr->left = eventPtr->xexpose.x;
+		areaPtr->top = eventPtr->xexpose.y;
+		areaPtr->right = eventPtr->xexpose.x + eventPtr->xexpose.width;
+		areaPtr->bottom = eventPtr->xexpose.y + eventPtr->xexpose.height;
+		Tcl_SetHashValue(hPtr, areaPtr);
+	    } else {
+		UnionExposeArea((ExposeArea *)Tcl_GetHashValue(hPtr), eventPtr);
+	    }
+	    return 1;
+	}
+	hPtr = Tcl_FindHashEntry(exposeTablePtr, INT2PTR(window));
+	if (hPtr != NULL) {
+	    areaPtr = (ExposeArea *)Tcl_GetHashValue(hPtr);
+	    UnionExposeArea(areaPtr, eventPtr);
+	    eventPtr->xexpose.x = areaPtr->left;
+	    eventPtr->xexpose.y = areaPtr->top;
+	    eventPtr->xexpose.width = areaPtr->right - areaPtr->left;
+	    eventPtr->xexpose.height = areaPtr->bottom - areaPtr->top;
+	    ckfree(areaPtr);
+	    Tcl_DeleteHashEntry(hPtr);
+	}
+	return 0;
+    }
+    return (state > 0);
+}
+
+/*
+ *----------------------------------------------------------------------
+ *
+ * UnionExposeArea --
+ *
+ *	Extend an ExposeArea to cover the area of an Expose event.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Modifies *areaPtr.
+ *
+ *----------------------------------------------------------------------
+ */
+
+static void
+UnionExposeArea(
+    ExposeArea *areaPtr,	/* Area to extend. */
+    XEvent *eventPtr)		/* Expose event. */
+{
+    int right = eventPtr->xexpose.x + eventPtr->xexpose.width;
+    int bottom = eventPtr->xexpose.y + eventPtr->xexpose.height;
+
+    if (eventPtr->xexpose.x < areaPtr->left) {
+	areaPtr->left = eventPtr->xexpose.x;
+    }
+    if (eventPtr->xexpose.y < areaPtr->top) {
+	areaPtr->top = eventPtr->xexpose.y;
+    }
+    if (right > areaPtr->right) {
+	areaPtr->right = right;
+    }
+    if (bottom > areaPtr->bottom) {
+	areaPtr->bottom = bottom;
+    }
+}
+
+/*
+ *----------------------------------------------------------------------
+ *
+ * ScanXEventQueue --
+ *
+ *	Look ahead in the X event queue for an event which supersedes candPtr.
+ *	At most MAX_COALESCE_SCAN events are taken off the queue for this, and
+ *	all of them are put back in their original order.
+ *
+ * Results:
+ *	1 if a superseding event was found, 0 or -1 otherwise (see
+ *	ScanQueuedEvent).
+ *
+ * Side effects:
+ *	None visible: the X event queue is left as it was found.
+ *
+ *----------------------------------------------------------------------
+ */
+
+static int
+ScanXEventQueue(
+    Display *display,		/* Display whose queue is scanned. */
+    XEvent *candPtr)		/* Event which may be superseded. */
+{
+    XEvent queued[MAX_COALESCE_SCAN];
+    int numQueued = 0, state = 0;
+
+    /*
+     * QLength only counts events already read from the connection, so the
+     * XNextEvent calls below never block or flush.
+     */
+
+    while ((state == 0) && (numQueued < MAX_COALESCE_SCAN)
+	    && (QLength(display) > 0)) {
+	XNextEvent(display, &queued[numQueued]);
+	state = ScanQueuedEvent(candPtr, &queued[numQueued]);
+	numQueued++;
+    }
+    if (numQueued == MAX_COALESCE_SCAN && state == 0) {
+	state = -1;
+    }
+
+    /*
+     * XPutBackEvent pushes onto the head of the queue, so put the events back
+     * last first.
+     */
+
+    while (numQueued > 0) {
+	XPutBackEvent(display, &queued[--numQueued]);
+    }
+    return state;
+}
+
+/*
+ *----------------------------------------------------------------------
+ *
+ * ScanQueuedEvent --
+ *
+ *	Check one queued event against a coalescing candidate. Events for
+ *	other windows are skipped; on the same window, Expose and
+ *	ConfigureNotify events may be reordered with respect to each other,
+ *	anything else ends the scan.
+ *
+ * Results:
+ *	0 to keep looking, 1 if eventPtr supersedes candPtr, -1 if eventPtr
+ *	must not be reordered with respect to candPtr.
+ *
+ * Side effects:
+ *	None.
+ *
+ *----------------------------------------------------------------------
+ */
+
+static int
+ScanQueuedEvent(
+    XEvent *candPtr,		/* Event which may be superseded. */
+    XEvent *eventPtr)		/* Queued event. */
+{
+    if (eventPtr->xany.window != candPtr->xany.window) {
+	return 0;
+    }
+    if (eventPtr->type == candPtr->type) {
+	if ((eventPtr->type != ConfigureNotify)
+		|| (eventPtr->xconfigure.window == candPtr->xconfigure.window)) {
+	    return 1;
+	}
+    } else if ((eventPtr->type != Expose)
+	    && (eventPtr->type != ConfigureNotify)) {
+	return -1;
+    }
+    return 0;
+}
+
 /*
  *----------------------------------------------------------------------
  *
@@ -38,12 +38,26 @@ typedef struct {
     int next;
 } UnixFtColorList;
 
+/*
+ * The list of fonts that fontconfig returns for a pattern is shared by all
+ * fonts, in all threads and applications, whose patterns are equal after
+ * substitution. The sets are kept in sharedSetTable, keyed by the unparsed
+ * pattern, and are freed when the last font using them is deleted.
+ */
+
+typedef struct {
+    FcFontSet *set;		/* Fonts matching the pattern, best first. */
+    size_t refCount;		/* Number of fonts using the set. */
+    Tcl_HashEntry *hashPtr;	/* Entry in sharedSetTable, or NULL if the
+				 * set is not shared. */
+} SharedFontSet;
+
 typedef struct {
     TkFont font;		/* Stuff used by generic font package. Must be
 				 * first in structure. */
     UnixFtFace *faces;
     int nfaces;
-    FcFontSet *fontset;
+    SharedFontSet *fontset;
     FcPattern *pattern;
 
     Display *display;
@@ -67,6 +81,13 @@ static Tcl_ThreadDataKey dataKey;
 TCL_DECLARE_MUTEX(xftMutex);
 #define LOCK Tcl_MutexLock(&xftMutex)
 #define UNLOCK Tcl_MutexUnlock(&xftMutex)
+
+/*
+ * Process-wide table of SharedFontSet structures, protected by xftMutex.
+ */
+
+static Tcl_HashTable sharedSetTable;
+static int sharedSetTableInit = 0;
 
 /*
  *-------------------------------------------------------------------------
@@ -284,6 +305,171 @@ static void
 FinishedWithFont(
     UnixFtFont *fontPtr);
 
+/*
+ *---------------------------------------------------------------------------
+ *
+ * DeleteSharedFontSetTable --
+ *
+ *	Exit handler that frees sharedSetTable.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Sets still used by some font are no longer shared; they are freed
+ *	when that font is deleted.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static void
+DeleteSharedFontSetTable(
+    TCL_UNUSED(void *))
+{
+    Tcl_HashEntry *hPtr;
+    Tcl_HashSearch search;
+
+    LOCK;
+    if (sharedSetTableInit) {
+	for (hPtr = Tcl_FirstHashEntry(&sharedSetTable, &search);
+		hPtr != NULL; hPtr = Tcl_NextHashEntry(&search)) {
+	    ((SharedFontSet *)Tcl_GetHashValue(hPtr))->hashPtr = NULL;
+	}
+	Tcl_DeleteHashTable(&sharedSetTable);
+	sharedSetTableInit = 0;
+    }
+    UNLOCK;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * GetSharedFontSet --
+ *
+ *	Finds the sorted list of fonts matching a substituted pattern, asking
+ *	fontconfig for it only if no other font has already done so.
+ *
+ * Results:
+ *	The shared set, with its reference count incremented, or NULL if no
+ *	font matches the pattern.
+ *
+ * Side effects:
+ *	A new set may be added to sharedSetTable.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static SharedFontSet *
+GetSharedFontSet(
+    FcPattern *pattern)
+{
+    SharedFontSet *sharedPtr, *otherPtr;
+    Tcl_HashEntry *hPtr;
+    FcFontSet *set;
+    FcResult result;
+    FcChar8 *key;
+    int isNew;
+
+    key = FcNameUnparse(pattern);
+    if (key != NULL) {
+	LOCK;
+	if (!sharedSetTableInit) {
+	    Tcl_InitHashTable(&sharedSetTable, TCL_STRING_KEYS);
+	    Tcl_CreateExitHandler(DeleteSharedFontSetTable, NULL);
+	    sharedSetTableInit = 1;
+	}
+	hPtr = Tcl_FindHashEntry(&sharedSetTable, (char *) key);
+	if (hPtr != NULL) {
+	    sharedPtr = (SharedFontSet *)Tcl_GetHashValue(hPtr);
+	    sharedPtr->refCount++;
+	    UNLOCK;
+	    FcStrFree(key);
+	    return sharedPtr;
+	}
+	UNLOCK;
+    }
+
+    /*
+     * Sorting can take a long time, so don't hold the lock while doing it.
+     */
+
+    set = FcFontSort(0, pattern, FcTrue, NULL, &result);
+    if (!set || set->nfont == 0) {
+	if (set) {
+	    FcFontSetDestroy(set);
+	}
+	if (key != NULL) {
+	    FcStrFree(key);
+	}
+	return NULL;
+    }
+    sharedPtr = (SharedFontSet *)ckalloc(sizeof(SharedFontSet));
+    sharedPtr->set = set;
+    sharedPtr->refCount = 1;
+    sharedPtr->hashPtr = NULL;
+    if (key == NULL) {
+	return sharedPtr;
+    }
+
+    /*
+     * Another thread may have added a set for the same pattern meanwhile;
+     * if so, use that one instead.
+     */
+
+    LOCK;
+    if (!sharedSetTableInit) {
+	UNLOCK;
+	FcStrFree(key);
+	return sharedPtr;
+    }
+    hPtr = Tcl_CreateHashEntry(&sharedSetTable, (char *) key, &isNew);
+    if (!isNew) {
+	otherPtr = (SharedFontSet *)Tcl_GetHashValue(hPtr);
+	otherPtr->refCount++;
+	UNLOCK;
+	FcStrFree(key);
+	FcFontSetDestroy(set);
+	ckfree(sharedPtr);
+	return otherPtr;
+    }
+    sharedPtr->hashPtr = hPtr;
+    Tcl_SetHashValue(hPtr, sharedPtr);
+    UNLOCK;
+    FcStrFree(key);
+    return sharedPtr;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * ReleaseSharedFontSet --
+ *
+ *	Called when a font no longer uses a set returned by GetSharedFontSet.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	The set is freed if no other font uses it.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static void
+ReleaseSharedFontSet(
+    SharedFontSet *sharedPtr)
+{
+    LOCK;
+    if (sharedPtr->refCount-- <= 1) {
+	if (sharedPtr->hashPtr != NULL) {
+	    Tcl_DeleteHashEntry(sharedPtr->hashPtr);
+	}
+	FcFontSetDestroy(sharedPtr->set);
+	ckfree(sharedPtr);
+    }
+    UNLOCK;
+}
+
 static int
 InitFontErrorProc(
     void *clientData,
@@ -305,7 +491,6 @@ InitFont(
 {
     FcFontSet *set;
     FcCharSet *charset;
-    FcResult result;
     XftFont *ftFont;
     int i, iWidth, errorFlag;
     Tk_ErrorHandler handler;
@@ -321,13 +506,13 @@ InitFont(
      * Generate the list of fonts
      */
 
-    set = FcFontSort(0, pattern, FcTrue, NULL, &result);
-    if (!set || set->nfont == 0) {
+    fontPtr->fontset = GetSharedFontSet(pattern);
+    if (!fontPtr->fontset) {
 	ckfree(fontPtr);
 	return NULL;
     }
 
-    fontPtr->fontset = set;
+    set = fontPtr->fontset->set;
     fontPtr->pattern = pattern;
     fontPtr->faces = (UnixFtFace *)ckalloc(set->nfont * sizeof(UnixFtFace));
     fontPtr->nfaces = set->nfont;
@@ -465,7 +650,7 @@ FinishedWithFont(
 	XUnloadFont(fontPtr->display, fontPtr->font.fid);
     }
     if (fontPtr->fontset) {
-	FcFontSetDestroy(fontPtr->fontset);
+	ReleaseSharedFontSet(fontPtr->fontset);
     }
     Tk_DeleteErrorHandler(handler);
 }
@@ -230,49 +230,6 @@ static const elem xColors[] = {
     "ellowGreen\0                 \232\315\062\0"
 };
 
-/*
- *----------------------------------------------------------------------
- *
- * XParseColor --
- *
- *	Partial implementation of X color name parsing interface.
- *
- * Results:
- *	Returns non-zero on success.
- *
- * Side effects:
- *	None.
- *
- *----------------------------------------------------------------------
- *
- * This only handles hex-strings without 0x prefix. Luckily, that's just what
- * we need.
- */
-
-static Tcl_WideInt
-parseHex64bit(
-    const char *spec,
-    char **p)
-{
-    Tcl_WideInt result = 0;
-    char c;
-    while ((c = *spec)) {
-	if ((c >= '0') && (c <= '9')) {
-	    c -= '0';
-	} else if ((c >= 'A') && (c <= 'F')) {
-	    c += (10 - 'A');
-	} else if ((c >= 'a') && (c <= 'f')) {
-	    c += (10 - 'a');
-	} else {
-	    break;
-	}
-	result = (result << 4) + c;
-	++spec;
-    }
-    *p = (char *) spec;
-    return result;
-}
-
 static int
 colorcmp(
     const char *spec,
@@ -334,6 +291,127 @@ colorcmp(
 #define BLUE(p)		((unsigned char) (p)[2])
 #define US(expr)	((unsigned short) (expr))
 
+/*
+ *----------------------------------------------------------------------
+ *
+ * TkParseColorName --
+ *
+ *	Look up a color name in the built-in table of X color names.
+ *
+ * Results:
+ *	Returns non-zero and fills in the red, green and blue fields of
+ *	*colorPtr if the name was found, returns 0 otherwise.
+ *
+ * Side effects:
+ *	None.
+ *
+ *----------------------------------------------------------------------
+ */
+
+int
+TkParseColorName(
+    const char *spec,
+    XColor *colorPtr)
+{
+    /*
+     * Perform a binary search on the sorted array of colors.
+     * size = current size of search range
+     * p    = pointer to current element being considered.
+     */
+
+    int size, num;
+    const elem *p;
+    const char *q;
+    int r = (spec[0] - 'A') & 0xdf;
+
+    if (r >= (int) sizeof(az) - 1) {
+	return 0;
+    }
+    size = az[r + 1] - az[r];
+    p = &xColors[(az[r + 1] + az[r]) >> 1];
+    r = colorcmp(spec + 1, *p, &num);
+
+    while (r != 0) {
+	if (r < 0) {
+	    size = (size >> 1);
+	    p -= ((size + 1) >> 1);
+	} else {
+	    --size;
+	    size = (size >> 1);
+	    p += ((size + 2) >> 1);
+	}
+	if (!size) {
+	    return 0;
+	}
+	r = colorcmp(spec + 1, *p, &num);
+    }
+    if (num > (*p)[31]) {
+	if (((*p)[31] != 8) || num > 100) {
+	    return 0;
+	}
+	num = (num * 255 + 50) / 100;
+	if ((num == 230) || (num == 128)) {
+	    /*
+	     * Those two entries have a deviation i.r.t the table.
+	     */
+
+	    num--;
+	}
+	num |= (num << 8);
+	colorPtr->red = colorPtr->green = colorPtr->blue = num;
+    } else {
+	q = *p + 28 - num * 3;
+	colorPtr->red = ((RED(q) << 8) | RED(q));
+	colorPtr->green = ((GREEN(q) << 8) | GREEN(q));
+	colorPtr->blue = ((BLUE(q) << 8) | BLUE(q));
+    }
+    return 1;
+}
+
+#if defined(_WIN32) || defined(MAC_OSX_TK)
+/*
+ *----------------------------------------------------------------------
+ *
+ * XParseColor --
+ *
+ *	Partial implementation of X color name parsing interface.
+ *
+ * Results:
+ *	Returns non-zero on success.
+ *
+ * Side effects:
+ *	None.
+ *
+ *----------------------------------------------------------------------
+ *
+ * This only handles hex-strings without 0x prefix. Luckily, that's just what
+ * we need.
+ */
+
+static Tcl_WideInt
+parseHex64bit(
+    const char *spec,
+    char **p)
+{
+    Tcl_WideInt result = 0;
+    char c;
+    while ((c = *spec)) {
+	if ((c >= '0') && (c <= '9')) {
+	    c -= '0';
+	} else if ((c >= 'A') && (c <= 'F')) {
+	    c += (10 - 'A');
+	} else if ((c >= 'a') && (c <= 'f')) {
+	    c += (10 - 'a');
+	} else {
+	    break;
+	}
+	result = (result << 4) + c;
+	++spec;
+    }
+    *p = (char *) spec;
+    return result;
+}
+
 Status
 XParseColor(
     TCL_UNUSED(Display *),
@@ -379,65 +457,15 @@ XParseColor(
 	default:
 	    return 0;
 	}
-    } else {
-	/*
-	 * Perform a binary search on the sorted array of colors.
-	 * size = current size of search range
-	 * p    = pointer to current element being considered.
-	 */
-
-	int size, num;
-	const elem *p;
-	const char *q;
-	int r = (spec[0] - 'A') & 0xdf;
-
-	if (r >= (int) sizeof(az) - 1) {
-	    return 0;
-	}
-	size = az[r + 1] - az[r];
-	p = &xColors[(az[r + 1] + az[r]) >> 1];
-	r = colorcmp(spec + 1, *p, &num);
-
-	while (r != 0) {
-	    if (r < 0) {
-		size = (size >> 1);
-		p -= ((size + 1) >> 1);
-	    } else {
-		--size;
-		size = (size >> 1);
-		p += ((size + 2) >> 1);
-	    }
-	    if (!size) {
-		return 0;
-	    }
-	    r = colorcmp(spec + 1, *p, &num);
-	}
-	if (num > (*p)[31]) {
-	    if (((*p)[31] != 8) || num > 100) {
-		return 0;
-	    }
-	    num = (num * 255 + 50) / 100;
-	    if ((num == 230) || (num == 128)) {
-		/*
-		 * Those two entries have a deviation i.r.t the table.
-		 */
-
-		num--;
-	    }
-	    num |= (num << 8);
-	    colorPtr->red = colorPtr->green = colorPtr->blue = num;
-	} else {
-	    q = *p + 28 - num * 3;
-	    colorPtr->red = ((RED(q) << 8) | RED(q));
-	    colorPtr->green = ((GREEN(q) << 8) | GREEN(q));
-	    colorPtr->blue = ((BLUE(q) << 8) | BLUE(q));
-	}
+    } else if (!TkParseColorName(spec, colorPtr)) {
+	return 0;
     }
     colorPtr->pixel = TkpGetPixel(colorPtr);
     colorPtr->flags = DoRed|DoGreen|DoBlue;
     colorPtr->pad = 0;
     return 1;
 }
+#endif /* _WIN32 || MAC_OSX_TK */
 
 /*
  * Local Variables: